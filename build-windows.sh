@@ -5,8 +5,9 @@ for include_folder in $(ls -d gtk+-mingw/include/*/); do
     INCLUDES="$INCLUDES -I$include_folder"
 done
 LIB='-Lgtk+-mingw/lib'
-LINK="$(pkg-config --libs gtk+-3.0) -lfreetype -std=c++14 -lstdc++ -lm"
-CC=i686-w64-mingw32-g++
+LINK="$(pkg-config --libs gtk+-3.0) -lfreetype -std=c++14 -lstdc++ -lm -pthread"
+# The posix thread model is needed for std::thread.
+CC=i686-w64-mingw32-g++-posix
 
 for source in $(find src -name '*.cpp'); do
     echo "Compiling $source..."
@@ -26,8 +27,9 @@ rm -r windows/src
 mv windows/bin/GraphColoring.exe windows/
 rmdir windows/bin
 
-cp /usr/lib/gcc/i686-w64-mingw32/6.3-win32/libgcc_s_sjlj-1.dll windows/
-cp /usr/lib/gcc/i686-w64-mingw32/6.3-win32/libstdc++-6.dll windows/
+cp /usr/lib/gcc/i686-w64-mingw32/6.3-posix/libgcc_s_sjlj-1.dll windows/
+cp /usr/lib/gcc/i686-w64-mingw32/6.3-posix/libstdc++-6.dll windows/
+cp /usr/i686-w64-mingw32/lib/libwinpthread-1.dll windows/
 cp gtk+-mingw/bin/*.dll windows/
 cp -r assets windows/
 echo 'Done!'
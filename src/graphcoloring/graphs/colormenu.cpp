@@ -18,21 +18,19 @@
 
 #include "colormenu.hpp"
 
-#include "../level.hpp"
 #include "utils/geometry.hpp"
 
 namespace graphcoloring {
 
-int ColorMenu::number_of_color_menus = 0;
-
-ColorMenu::ColorMenu(gui::Window* window_, int x_, int y_,
-	const gui::Position& viewport_position_,
+ColorMenu::ColorMenu(LevelContext& context_, gui::Window* window_,
+	int x_, int y_, const gui::Viewport& viewport_position_,
 	std::function<void(gui::Color)> color_click_callback_)
-	: window(window_), x(x_), y(y_), viewport_position(viewport_position_),
+	: context(context_), window(window_), x(x_), y(y_),
+	  viewport_position(viewport_position_),
 	  color_click_callback(color_click_callback_)
 {
-	number_of_color_menus++;
-	if (number_of_color_menus == 1)
+	context.number_of_color_menus++;
+	if (context.number_of_color_menus == 1)
 	{
 		MakeButtons();
 		callback_id = window->SetMousedownCallback([this](gui::Window*,int x,int y){
@@ -45,13 +43,16 @@ ColorMenu::ColorMenu(gui::Window* window_, int x_, int y_,
 	{
 		callback_id = -1;
 	}
+	// Even if creation failed, Render must run to close the menu.
+	window->Invalidate(Bounds());
 }
 
 ColorMenu::~ColorMenu()
 {
 	if (callback_id != -1)
 		window->RemoveMousedownCallback(callback_id);
-	number_of_color_menus--;
+	context.number_of_color_menus--;
+	window->Invalidate(Bounds());
 }
 
 void ColorMenu::SetCloseCallback(std::function<void()> close_callback_)
@@ -61,7 +62,7 @@ void ColorMenu::SetCloseCallback(std::function<void()> close_callback_)
 
 int ColorMenu::GetWidth() const
 {
-	int number_of_colors = Level::colors.size();
+	int number_of_colors = context.colors.size();
 	return SPACING  + (SPACING + 2 * CIRCLE_RADIUS) * number_of_colors;
 }
 
@@ -73,10 +74,10 @@ int ColorMenu::GetHeight() const
 void ColorMenu::MakeButtons()
 {
 	int xpos = x + SPACING;
-	for (gui::Color color : Level::colors)
+	for (gui::Color color : context.colors)
 	{
 		gui::Position pos(xpos, y + SPACING, 0, 0, nullptr,
-			&negative_viewport_position);
+			&button_offset);
 		gui::Size size(CIRCLE_RADIUS);
 		std::unique_ptr<gui::Button> button(
 			new gui::Button(window, "", pos, size,
@@ -99,20 +100,27 @@ void ColorMenu::Render()
 		return;
 	}
 
-	int view_x = viewport_position.x;
-	int view_y = viewport_position.y;
-	negative_viewport_position.SetPos(-view_x, -view_y);
+	// The menu stays the same size when zoomed, but follows its position.
+	int screen_x = viewport_position.ScreenX(x);
+	int screen_y = viewport_position.ScreenY(y);
+	button_offset.SetPos(screen_x - x, screen_y - y);
 
 	window->SetDrawColor(BACKGROUND_COLOR);
-	window->DrawRectangle(x-view_x, y-view_y, GetWidth(), GetHeight(), true);
+	window->DrawRectangle(screen_x, screen_y, GetWidth(), GetHeight(), true);
 	for (std::unique_ptr<gui::Button>& button : buttons)
 		button->Render();
 }
 
+gui::Rectangle ColorMenu::Bounds() const
+{
+	return gui::Rectangle{viewport_position.ScreenX(x),
+		viewport_position.ScreenY(y), GetWidth(), GetHeight()}.Padded(1);
+}
+
 bool ColorMenu::IsInsideMenu(int mx, int my) const
 {
 	return utils::geometry::InRectangle(mx, my,
-		x-viewport_position.X(), y-viewport_position.Y(),
+		viewport_position.ScreenX(x), viewport_position.ScreenY(y),
 		GetWidth(), GetHeight());
 }
 
@@ -21,6 +21,8 @@
 
 #include "gui/window.hpp"
 #include "gui/button.hpp"
+#include "gui/viewport.hpp"
+#include "../levelcontext.hpp"
 
 #include <memory>
 
@@ -28,8 +30,8 @@ namespace graphcoloring {
 
 class ColorMenu {
 public:
-	ColorMenu(gui::Window* window, int x, int y,
-		const gui::Position& viewport_position,
+	ColorMenu(LevelContext& context, gui::Window* window, int x, int y,
+		const gui::Viewport& viewport_position,
 		std::function<void(gui::Color)> color_click_callback);
 	virtual ~ColorMenu();
 	void Render();
@@ -37,17 +39,18 @@ public:
 	int GetWidth() const;
 	int GetHeight() const;
 	bool IsInsideMenu(int x, int y) const; // Is this mouse position inside the menu?
+	gui::Rectangle Bounds() const; // Area covered when rendered
 private:
 	void MakeButtons();
 	static constexpr int CIRCLE_RADIUS = 20;
 	static constexpr int SPACING = 10;
 	static constexpr gui::Color BACKGROUND_COLOR = 0x222222FF;
-	static int number_of_color_menus; // Number of color menus open.
 	int callback_id;
+	LevelContext& context;
 	gui::Window* const window;
 	const int x, y;
-	const gui::Position& viewport_position;
-	gui::Position negative_viewport_position;
+	const gui::Viewport& viewport_position;
+	gui::Position button_offset; // From world to screen coordinates
 	std::vector<std::unique_ptr<gui::Button>> buttons;
 	std::function<void(gui::Color)> color_click_callback;
 	std::function<void()> close_callback;
@@ -27,17 +27,11 @@
 
 namespace graphcoloring {
 
-int Edge::id_counter = 0;
-
-void Edge::ResetID()
-{
-	id_counter = 0;
-}
-
-
-Edge::Edge(gui::Window* window_, Vertex& from_, Vertex& to_, gui::Color color_,
-	const gui::Position& viewport_position_, bool directed_)
-	: id(id_counter++), from(from_), to(to_), window(window_),
+Edge::Edge(LevelContext& context_, gui::Window* window_, Vertex& from_,
+	Vertex& to_, gui::Color color_, const gui::Viewport& viewport_position_,
+	bool directed_)
+	: id(context_.next_edge_id++), from(from_), to(to_), context(context_),
+	  window(window_),
 	  viewport_position(viewport_position_)
 {
 	color = color_;
@@ -84,6 +78,15 @@ bool Edge::IsHovering() const
 	return hovering;
 }
 
+gui::Rectangle Edge::Bounds() const
+{
+	// The arrowhead is in world space, so it scales with the zoom.
+	int arrow_size = viewport_position.ScreenLength(ARROW_SIZE);
+	return gui::Rectangle::Around(from.RenderX(), from.RenderY(),
+		to.RenderX(), to.RenderY())
+		.Padded(arrow_size + Vertex::BOUNDS_PADDING);
+}
+
 bool Edge::IsAdjacentTo(const Edge& edge) const
 {
 	return edge.HasEndpoint(from.id) || edge.HasEndpoint(to.id);
@@ -94,6 +97,11 @@ void Edge::SetDeleteCallback(std::function<void()> delete_callback_)
 	delete_callback = delete_callback_;
 }
 
+void Edge::SetChangeCallback(change_callback_t change_callback_)
+{
+	change_callback = change_callback_;
+}
+
 gui::Color Edge::Color() const
 {
 	return color;
@@ -102,6 +110,8 @@ gui::Color Edge::Color() const
 bool Edge::ChangeColor(gui::Color new_color)
 {
 	if (is_color_protected) return false;
+	if (new_color != color && change_callback)
+		change_callback(color, new_color);
 	color = new_color;
 	return true;
 }
@@ -118,45 +128,69 @@ bool Edge::HasEndpoint(int v_id) const
 	return from.id == v_id || to.id == v_id;
 }
 
-void Edge::Render(bool is_in_path)
+void Edge::CheckHovering()
 {
 	int dist = utils::geometry::PointToLineSegmentDistance(
-		window->GetMouseX(), window->GetMouseY(),
-		from.RenderX(), from.RenderY(), to.RenderX(), to.RenderY(),
-		EDGE_CLICK_TOLERANCE);
+		viewport_position.WorldX(window->GetMouseX()),
+		viewport_position.WorldY(window->GetMouseY()),
+		from.x, from.y, to.x, to.y, EDGE_CLICK_TOLERANCE);
 	hovering = dist < EDGE_CLICK_TOLERANCE && dist != -1;
-	int from_x = from.RenderX();
-	int from_y = from.RenderY();
-	int to_x   =   to.RenderX();
-	int to_y   =   to.RenderY();
+}
 
-	double theta1 = utils::geometry::LineAngle(from_x, from_y, to_x, to_y);
-	double theta2 = utils::geometry::LineAngle(to_x, to_y, from_x, from_y);
+void Edge::UpdateGeometry(const std::vector<Edge*>& edges)
+{
+	for (Edge* e : edges)
+		e->UpdateGeometry();
+}
 
-	int x1 = from_x + Vertex::VERTEX_RADIUS * std::cos(theta1);
-	int y1 = from_y + Vertex::VERTEX_RADIUS * std::sin(theta1);
+void Edge::UpdateGeometry()
+{
+	Geometry& g = geometry;
+	g.from_x = from.x;
+	g.from_y = from.y;
+	g.to_x = to.x;
+	g.to_y = to.y;
+	// Unit vector from one endpoint to the other.
+	double dx = g.to_x - g.from_x, dy = g.to_y - g.from_y;
+	double length = std::sqrt(dx*dx + dy*dy);
+	if (length > 0)
+	{
+		dx /= length;
+		dy /= length;
+	}
+	double r = Vertex::VERTEX_RADIUS;
+	g.x1 = g.from_x + r * dx;
+	g.y1 = g.from_y + r * dy;
+	g.x2 = g.to_x - r * dx;
+	g.y2 = g.to_y - r * dy;
+	// The arrowhead's sides point back along the edge, turned by 45 degrees
+	// either way.
+	double a = ARROW_SIZE * M_SQRT1_2;
+	g.x3 = g.x2 - a * (dx - dy);
+	g.y3 = g.y2 - a * (dy + dx);
+	g.x4 = g.x2 - a * (dx + dy);
+	g.y4 = g.y2 - a * (dy - dx);
+	is_geometry_valid = true;
+}
 
-	int x2 = to_x + Vertex::VERTEX_RADIUS * std::cos(theta2);
-	int y2 = to_y + Vertex::VERTEX_RADIUS * std::sin(theta2);
+void Edge::Render(bool is_in_path)
+{
+	const Geometry& g = geometry;
+	if (!is_geometry_valid || g.from_x != from.x || g.from_y != from.y
+	 || g.to_x != to.x || g.to_y != to.y)
+		UpdateGeometry();
+
+	const gui::Viewport& view = viewport_position;
+	int x2 = view.ScreenX(g.x2), y2 = view.ScreenY(g.y2);
 
 	window->SetDrawColor(is_in_path ? gui::colors::WHITE : color);
-	window->DrawLine(x1, y1, x2, y2);
+	window->DrawLine(view.ScreenX(g.x1), view.ScreenY(g.y1), x2, y2);
 
 	if (directed)
 	{
-		double theta3 = theta2 - M_PI / 4;
-		double theta4 = theta2 + M_PI / 4;
-
-		int x3 = x2 + ARROW_SIZE * std::cos(theta3);
-		int y3 = y2 + ARROW_SIZE * std::sin(theta3);
-
-		int x4 = x2 + ARROW_SIZE * std::cos(theta4);
-		int y4 = y2 + ARROW_SIZE * std::sin(theta4);
-
-		window->DrawLine(x2, y2, x3, y3);
-		window->DrawLine(x2, y2, x4, y4);
+		window->DrawLine(x2, y2, view.ScreenX(g.x3), view.ScreenY(g.y3));
+		window->DrawLine(x2, y2, view.ScreenX(g.x4), view.ScreenY(g.y4));
 	}
-
 }
 
 void Edge::RenderColorMenu()
@@ -177,8 +211,8 @@ void Edge::MouseCallback(int mouse_x, int mouse_y)
 		color_menu = nullptr;
 	};
 
-	color_menu = std::make_unique<ColorMenu>(window,
-		mouse_x+viewport_position.X(), mouse_y+viewport_position.Y(),
+	color_menu = std::make_unique<ColorMenu>(context, window,
+		viewport_position.WorldX(mouse_x), viewport_position.WorldY(mouse_y),
 		viewport_position, callback);
 
 	std::function<void()> close_callback = [this] () {
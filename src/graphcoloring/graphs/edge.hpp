@@ -27,23 +27,31 @@ namespace graphcoloring {
 
 class Edge {
 public:
-	static void ResetID();
-	Edge(gui::Window* window, Vertex& from, Vertex& to,
-		gui::Color color, const gui::Position& viewport_position,
+	typedef std::function<void(gui::Color old_color, gui::Color new_color)>
+		change_callback_t;
+	Edge(LevelContext& context, gui::Window* window, Vertex& from, Vertex& to,
+		gui::Color color, const gui::Viewport& viewport_position,
 		bool directed = false);
 	virtual ~Edge();
 	int OtherEndpoint(int vertex_id) const;
 	void Lock();
 	void Unlock();
 	bool IsHovering() const;
+	gui::Rectangle Bounds() const; // Area covered when rendered
 	bool IsAdjacentTo(const Edge& edge) const;
 	void SetDeleteCallback(std::function<void()> delete_callback);
+	void SetChangeCallback(change_callback_t change_callback); // Called when the color changes
 	bool ChangeColor(gui::Color new_color); // Returns false if edge is color protected.
 	gui::Color Color() const;
 	bool HasEndpoint(int id) const; // Does this edge have this endpoint?
 	bool HasEndpoints(int id1, int id2) const; // Does this edge have these endpoints?
 	void Render(bool is_in_path = false);
 	void RenderColorMenu(); // Color menu rendering is handled separately
+	void CheckHovering();
+	// Recomputes where the edges are drawn, e.g. after a vertex moves. This
+	// also happens when an edge is next drawn, if it's needed.
+	static void UpdateGeometry(const std::vector<Edge*>& edges);
+	static constexpr int EDGE_CLICK_TOLERANCE = 10;
 	const int id;
 	Vertex& from;
 	Vertex& to;
@@ -51,19 +59,29 @@ public:
 	bool is_delete_protected = false;
 private:
 	void MouseCallback(int mouse_x, int mouse_y);
-	static constexpr int EDGE_CLICK_TOLERANCE = 10;
+	void UpdateGeometry();
 	static constexpr int ARROW_SIZE = 10;
-	static int id_counter;
+	// Where the edge is drawn, in world coordinates.
+	struct Geometry
+	{
+		int from_x, from_y, to_x, to_y; // Endpoints it was computed for
+		double x1, y1, x2, y2; // The line, trimmed to the vertices' circles
+		double x3, y3, x4, y4; // Ends of the arrowhead, which starts at (x2, y2)
+	};
+	Geometry geometry;
+	bool is_geometry_valid = false;
+	LevelContext& context;
 	gui::Window* const window;
 	gui::Color color;
 	std::unique_ptr<ColorMenu> color_menu;
-	const gui::Position& viewport_position;
+	const gui::Viewport& viewport_position;
 	bool directed;
 	bool hovering = false;
 	bool is_locked = false;
 	int mousedown_callback_id;
 	int x_keyup_callback_id;
 	std::function<void()> delete_callback;
+	change_callback_t change_callback;
 };
 
 } // namespace graphcoloring
@@ -0,0 +1,225 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "edgecoloring.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+
+#include "utils/errors.hpp"
+
+namespace graphcoloring {
+
+EdgeColoring::EdgeColoring(const Graph& graph)
+{
+	std::unordered_map<int, int> indices; // Vertex ID => index
+	for (const Vertex* v : graph.vertices)
+	{
+		int index = indices.size();
+		indices[v->id] = index;
+	}
+	int n = indices.size();
+	std::vector<int> degree(n, 0);
+	for (const Edge* e : graph.edges)
+	{
+		edge_indices[e->id] = from.size();
+		from.push_back(indices.at(e->from.id));
+		to.push_back(indices.at(e->to.id));
+		if (from.back() != to.back())
+		{
+			degree[from.back()]++;
+			degree[to.back()]++;
+		}
+	}
+	max_degree = n ? *std::max_element(degree.begin(), degree.end()) : 0;
+	K = max_degree + 1;
+	colors.assign(from.size(), -1);
+	edge_at.assign(n * K, -1);
+	fan_mark.assign(n, -1);
+
+	std::set<std::pair<int,int>> seen;
+	for (int e = 0; e < (int)from.size(); e++)
+	{
+		std::pair<int,int> endpoints = std::minmax(from[e], to[e]);
+		if (from[e] == to[e] || !seen.insert(endpoints).second)
+			continue;
+		ColorEdge(e);
+	}
+	number_of_colors = 0;
+	for (int c : colors)
+		number_of_colors = std::max(number_of_colors, c + 1);
+}
+
+int EdgeColoring::MaxDegree() const
+{
+	return max_degree;
+}
+
+int EdgeColoring::NumberOfColors() const
+{
+	return number_of_colors;
+}
+
+int EdgeColoring::ColorOf(int edge_id) const
+{
+	return colors[edge_indices.at(edge_id)];
+}
+
+int EdgeColoring::Other(int e, int v) const
+{
+	return from[e] == v ? to[e] : from[e];
+}
+
+bool EdgeColoring::IsFree(int v, int c) const
+{
+	return edge_at[v * K + c] == -1;
+}
+
+int EdgeColoring::FreeColor(int v) const
+{
+	for (int c = 0; c < K; c++)
+		if (IsFree(v, c))
+			return c;
+	utils::errors::Die("No free color in edge coloring.");
+	return -1;
+}
+
+void EdgeColoring::SetColor(int e, int c)
+{
+	colors[e] = c;
+	edge_at[from[e] * K + c] = e;
+	edge_at[to[e] * K + c] = e;
+}
+
+void EdgeColoring::UnsetColor(int e)
+{
+	edge_at[from[e] * K + colors[e]] = -1;
+	edge_at[to[e] * K + colors[e]] = -1;
+	colors[e] = -1;
+}
+
+void EdgeColoring::InvertPath(int x, int c, int d)
+{
+	if (c == d) return;
+	std::vector<int> path;
+	for (int color = d; !IsFree(x, color); color = color == d ? c : d)
+	{
+		int e = edge_at[x * K + color];
+		path.push_back(e);
+		x = Other(e, x);
+	}
+	std::vector<int> old_colors;
+	for (int e : path)
+	{
+		old_colors.push_back(colors[e]);
+		UnsetColor(e);
+	}
+	for (int i = 0; i < (int)path.size(); i++)
+		SetColor(path[i], old_colors[i] == c ? d : c);
+}
+
+void EdgeColoring::ColorEdge(int e)
+{
+	int u = from[e];
+	// A maximal fan of u: edges u-F[0], u-F[1], ... where e = u-F[0] and the
+	// color of u-F[i+1] is free at F[i].
+	std::vector<int> fan = {e};
+	int last = to[e];
+	fan_mark[last] = e;
+	for (;;)
+	{
+		int next = -1;
+		for (int c = 0; c < K && next == -1; c++)
+		{
+			int f = edge_at[u * K + c];
+			if (f != -1 && IsFree(last, c) && fan_mark[Other(f, u)] != e)
+				next = f;
+		}
+		if (next == -1) break;
+		fan.push_back(next);
+		last = Other(next, u);
+		fan_mark[last] = e;
+	}
+
+	int c = FreeColor(u), d = FreeColor(last);
+	InvertPath(u, c, d); // Now d is free at u.
+	// Rotate the fan up to the first vertex where d is free, and give that
+	// edge d.
+	int w = 0;
+	while (!IsFree(Other(fan[w], u), d))
+		w++;
+	for (int i = 0; i < w; i++)
+	{
+		int color = colors[fan[i+1]];
+		UnsetColor(fan[i+1]);
+		SetColor(fan[i], color);
+	}
+	SetColor(fan[w], d);
+}
+
+int EdgeColoring::Conflicts(const Graph& graph)
+{
+	std::unordered_map<int, int> vertex_indices;
+	for (const Vertex* v : graph.vertices)
+	{
+		int index = vertex_indices.size();
+		vertex_indices[v->id] = index;
+	}
+	std::unordered_map<gui::Color, int> color_indices;
+	std::vector<int> edge_colors, endpoints;
+	for (const Edge* e : graph.edges)
+	{
+		auto it = color_indices.emplace(e->Color(), color_indices.size()).first;
+		edge_colors.push_back(it->second);
+		endpoints.push_back(vertex_indices.at(e->from.id));
+		endpoints.push_back(vertex_indices.at(e->to.id));
+	}
+
+	// seen: colors at each vertex; repeated: colors at least twice there.
+	int words = (color_indices.size() + 63) / 64;
+	std::vector<uint64_t> seen(vertex_indices.size() * words, 0);
+	std::vector<uint64_t> repeated(seen.size(), 0);
+	for (int e = 0; e < (int)edge_colors.size(); e++)
+	{
+		uint64_t bit = (uint64_t)1 << (edge_colors[e] % 64);
+		for (int v : {endpoints[2*e], endpoints[2*e+1]})
+		{
+			int word = v * words + edge_colors[e] / 64;
+			repeated[word] |= seen[word] & bit;
+			seen[word] |= bit;
+		}
+	}
+	int conflicts = 0;
+	for (int e = 0; e < (int)edge_colors.size(); e++)
+	{
+		uint64_t bit = (uint64_t)1 << (edge_colors[e] % 64);
+		int word1 = endpoints[2*e] * words + edge_colors[e] / 64;
+		int word2 = endpoints[2*e+1] * words + edge_colors[e] / 64;
+		if ((repeated[word1] | repeated[word2]) & bit)
+			conflicts++;
+	}
+	return conflicts;
+}
+
+bool EdgeColoring::IsProper(const Graph& graph)
+{
+	return Conflicts(graph) == 0;
+}
+
+} // namespace graphcoloring
@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_GRAPHS_EDGECOLORING_H_
+#define GRAPHCOLORING_GRAPHS_EDGECOLORING_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "graph.hpp"
+
+namespace graphcoloring {
+
+// Proper edge colorings (no two edges with a common endpoint have the same
+// color). Edges are treated as undirected.
+class EdgeColoring {
+public:
+	// Colors the graph's edges with at most MaxDegree()+1 colors (Misra-Gries),
+	// in O(E*(V+MaxDegree()^2)). Loops and repeated edges are left uncolored.
+	EdgeColoring(const Graph& graph);
+	virtual ~EdgeColoring() {}
+	int MaxDegree() const;
+	int NumberOfColors() const;
+	int ColorOf(int edge_id) const; // 0 to NumberOfColors()-1, or -1 if uncolored
+	// Number of edges which share a color with an adjacent edge, from the
+	// edges' own colors. O(V+E), with a bitset of the colors at each vertex.
+	static int Conflicts(const Graph& graph);
+	static bool IsProper(const Graph& graph); // Conflicts(graph) == 0
+private:
+	void ColorEdge(int e);
+	void InvertPath(int x, int c, int d); // Swap c and d on the cd path starting at x
+	void SetColor(int e, int c);
+	void UnsetColor(int e);
+	int FreeColor(int v) const;
+	bool IsFree(int v, int c) const;
+	int Other(int e, int v) const; // The endpoint of e which isn't v
+	std::unordered_map<int, int> edge_indices; // Edge ID => index
+	std::vector<int> from, to; // Endpoint indices of each edge
+	std::vector<int> colors; // Of each edge
+	std::vector<int> edge_at; // [v*K + c] = the edge at v with color c, or -1
+	std::vector<int> fan_mark; // Which ColorEdge call last put v in a fan
+	int K; // MaxDegree()+1
+	int max_degree;
+	int number_of_colors;
+};
+
+} // namespace graphcoloring
+
+#endif // GRAPHCOLORING_GRAPHS_EDGECOLORING_H_
@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "eulerian.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace graphcoloring {
+
+Eulerian::Eulerian(const Graph& graph)
+	: adjacency(graph.V())
+{
+	std::unordered_map<int, int> indices; // Vertex ID => index
+	for (const Vertex* v : graph.vertices)
+	{
+		indices[v->id] = vertex_ids.size();
+		vertex_ids.push_back(v->id);
+	}
+	for (const Edge* e : graph.edges)
+	{
+		int from = indices.at(e->from.id), to = indices.at(e->to.id);
+		int edge_index = edge_ids.size();
+		edge_ids.push_back(e->id);
+		adjacency[from].push_back(std::make_pair(to, edge_index));
+		adjacency[to].push_back(std::make_pair(from, edge_index));
+	}
+	for (int v = 0; v < (int)adjacency.size(); v++)
+		if (adjacency[v].size() % 2)
+			odd_vertices.push_back(v);
+	CheckConnected();
+}
+
+void Eulerian::CheckConnected()
+{
+	// Isolated vertices don't matter, so start from any vertex with an edge.
+	int start = -1;
+	for (int v = 0; v < (int)adjacency.size() && start == -1; v++)
+		if (!adjacency[v].empty())
+			start = v;
+	is_connected = true;
+	if (start == -1)
+		return;
+
+	std::vector<bool> visited(adjacency.size(), false);
+	std::vector<int> stack = {start};
+	visited[start] = true;
+	while (!stack.empty())
+	{
+		int v = stack.back();
+		stack.pop_back();
+		for (const std::pair<int,int>& neighbor : adjacency[v])
+		{
+			if (visited[neighbor.first]) continue;
+			visited[neighbor.first] = true;
+			stack.push_back(neighbor.first);
+		}
+	}
+	for (int v = 0; v < (int)adjacency.size(); v++)
+		if (!adjacency[v].empty() && !visited[v])
+			is_connected = false;
+}
+
+bool Eulerian::HasPath() const
+{
+	return is_connected && odd_vertices.size() <= 2;
+}
+
+bool Eulerian::HasCycle() const
+{
+	return is_connected && odd_vertices.empty();
+}
+
+Eulerian::Trail Eulerian::FindTrail() const
+{
+	Trail trail;
+	if (!HasPath() || edge_ids.empty())
+		return trail;
+	int start = 0;
+	if (!odd_vertices.empty())
+		start = odd_vertices[0]; // A path has to start at an odd vertex.
+	else
+		while (adjacency[start].empty())
+			start++;
+
+	std::vector<bool> used(edge_ids.size(), false);
+	std::vector<unsigned> next(adjacency.size(), 0); // Next edge to try from each vertex
+	std::vector<std::pair<int,int>> stack = {std::make_pair(start, -1)}; // (vertex, edge used to get there)
+	while (!stack.empty())
+	{
+		int v = stack.back().first;
+		while (next[v] < adjacency[v].size() && used[adjacency[v][next[v]].second])
+			next[v]++;
+		if (next[v] == adjacency[v].size())
+		{
+			// Dead end: this edge goes at the end of what is left of the trail.
+			if (stack.back().second != -1)
+				trail.edges.push_back(edge_ids[stack.back().second]);
+			stack.pop_back();
+		}
+		else
+		{
+			const std::pair<int,int>& neighbor = adjacency[v][next[v]];
+			used[neighbor.second] = true;
+			stack.push_back(neighbor);
+		}
+	}
+	std::reverse(trail.edges.begin(), trail.edges.end());
+	trail.first_vertex = vertex_ids[start];
+	return trail;
+}
+
+} // namespace graphcoloring
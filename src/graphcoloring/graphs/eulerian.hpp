@@ -0,0 +1,53 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_GRAPHS_EULERIAN_H_
+#define GRAPHCOLORING_GRAPHS_EULERIAN_H_
+
+#include <vector>
+
+#include "graph.hpp"
+
+namespace graphcoloring {
+
+// Eulerian paths and cycles (trails which use every edge exactly once).
+// Edges are treated as undirected. Everything is O(V+E).
+class Eulerian {
+public:
+	struct Trail
+	{
+		int first_vertex = -1; // -1 if there is no trail, or no edges.
+		std::vector<int> edges; // Edge IDs, in order
+	};
+	Eulerian(const Graph& graph);
+	virtual ~Eulerian() {}
+	bool HasPath() const;
+	bool HasCycle() const;
+	Trail FindTrail() const; // A cycle if there is one, otherwise a path (Hierholzer's algorithm).
+private:
+	void CheckConnected();
+	std::vector<int> vertex_ids; // Vertex ID of each index
+	std::vector<int> edge_ids;
+	std::vector<std::vector<std::pair<int,int>>> adjacency; // (neighbor index, edge index)
+	std::vector<int> odd_vertices; // Indices of vertices with odd degree
+	bool is_connected; // Are all of the edges in one component?
+};
+
+} // namespace graphcoloring
+
+#endif // GRAPHCOLORING_GRAPHS_EULERIAN_H_
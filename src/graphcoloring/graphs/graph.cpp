@@ -21,21 +21,72 @@
 #include <sstream>
 #include <cassert>
 #include <stack>
+#include <map>
+#include <algorithm>
 
-#include "../level.hpp"
 #include "utils/errors.hpp"
+#include "utils/profiler.hpp"
 
 namespace graphcoloring {
 
+namespace {
+
+// Zobrist keys. IDs and colors aren't bounded, so rather than looking the
+// keys up in tables of random numbers, they're made by mixing the values
+// with SplitMix64's finalizer.
+uint64_t Mix(uint64_t x)
+{
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+enum KeyKind { VERTEX_KEY, VERTEX_COLOR_KEY, EDGE_KEY, EDGE_COLOR_KEY };
+
+uint64_t Key(KeyKind kind, uint64_t a, uint64_t b = 0, uint64_t c = 0)
+{
+	return Mix(Mix(Mix(Mix(kind) ^ a) ^ b) ^ c);
+}
+
+uint64_t VertexKey(const Vertex& v)
+{
+	return Key(VERTEX_KEY, v.id) ^ Key(VERTEX_COLOR_KEY, v.id, v.Color());
+}
+
+// Edges are keyed by their endpoints (in order if the graph is directed),
+// not their IDs, so deleting an edge and adding it again gives back the same
+// hash.
+uint64_t EdgeEnds(const Edge& e, bool directed)
+{
+	uint32_t from = e.from.id, to = e.to.id;
+	if (!directed && to < from) std::swap(from, to);
+	return (uint64_t)from << 32 | to;
+}
+
+uint64_t EdgeColorKey(const Edge& e, bool directed, gui::Color color)
+{
+	return Key(EDGE_COLOR_KEY, EdgeEnds(e, directed), color);
+}
+
+uint64_t EdgeKey(const Edge& e, bool directed)
+{
+	return Key(EDGE_KEY, EdgeEnds(e, directed))
+		^ EdgeColorKey(e, directed, e.Color());
+}
+
+} // namespace
+
 void Graph::ResetIDs()
 {
-	Vertex::ResetID();
-	Edge::ResetID();
+	context.next_vertex_id = 0;
+	context.next_edge_id = 0;
 }
 
-Graph::Graph(gui::Window* window_, const gui::Position& viewport_position_,
-		bool directed_)
-	: window(window_), viewport_position(viewport_position_),
+Graph::Graph(LevelContext& context_, gui::Window* window_,
+		const gui::Viewport& viewport_position_, bool directed_)
+	: context(context_), window(window_),
+	  viewport_position(viewport_position_),
 	  edge_vertex(-1)
 {
 	directed = directed_;
@@ -43,11 +94,15 @@ Graph::Graph(gui::Window* window_, const gui::Position& viewport_position_,
 	v_keyup_callback =
 		window->SetKeyupCallback([this] (gui::Window*) {
 			if (can_add_new_vertices && !is_locked)
-				AddVertex(window->GetMouseX()+viewport_position.X(),
-						  window->GetMouseY()+viewport_position.Y());
+				AddVertex(viewport_position.WorldX(window->GetMouseX()),
+						  viewport_position.WorldY(window->GetMouseY()));
 		}, GDK_KEY_v);
 	e_keyup_callback =
 		window->SetKeyupCallback([this] (gui::Window*){EPressed();}, GDK_KEY_e);
+	mousemotion_callback =
+		window->SetMousemotionCallback([this] (gui::Window*, int, int) {
+			MouseMoved();
+		});
 }
 
 Graph::~Graph()
@@ -56,6 +111,7 @@ Graph::~Graph()
 
 	window->RemoveKeyupCallback(v_keyup_callback, GDK_KEY_v);
 	window->RemoveKeyupCallback(e_keyup_callback, GDK_KEY_e);
+	window->RemoveMousemotionCallback(mousemotion_callback);
 }
 
 int Graph::V() const
@@ -81,7 +137,9 @@ void Graph::Clear()
 		delete e;
 	vertices.clear();
 	edges.clear();
+	hash = 0;
 	ResetIDs();
+	Changed();
 }
 
 void Graph::Lock()
@@ -215,28 +273,166 @@ const Edge& Graph::GetEdgeByIDConst(int id) const
 
 int Graph::GetHoveringVertex() const
 {
-	for (const Vertex* v : vertices)
-		if (v->IsHovering())
-			return v->id;
-	return -1;
+	if (!is_indexed) // Hovering hasn't been updated since the graph changed.
+	{
+		for (const Vertex* v : vertices)
+			if (v->IsHovering())
+				return v->id;
+		return -1;
+	}
+	int id = -1;
+	for (const Vertex* v : hovering_vertices)
+		if (id == -1 || v->id < id)
+			id = v->id;
+	return id;
 }
 
 int Graph::GetHoveringEdge() const
 {
-	for (const Edge* e : edges)
-		if (e->IsHovering())
-			return e->id;
-	return -1;
+	if (!is_indexed)
+	{
+		for (const Edge* e : edges)
+			if (e->IsHovering())
+				return e->id;
+		return -1;
+	}
+	int id = -1;
+	for (const Edge* e : hovering_edges)
+		if (id == -1 || e->id < id)
+			id = e->id;
+	return id;
 }
 
-int Graph::AddVertex(Vertex* v)
+void Graph::MouseMoved()
+{
+	int x = viewport_position.WorldX(window->GetMouseX());
+	int y = viewport_position.WorldY(window->GetMouseY());
+	if (context.moving_vertex != -1 && HasVertexWithID(context.moving_vertex))
+		MoveVertex(GetVertexByID(context.moving_vertex), x, y);
+	UpdateHovering();
+	if (edge_vertex != -1)
+		window->Invalidate(); // The new edge follows the mouse.
+}
+
+void Graph::UpdateHovering()
+{
+	// Only the elements which were being hovered over, and the ones near the
+	// mouse, can have changed.
+	std::vector<Vertex*> candidate_vertices;
+	std::vector<Edge*> candidate_edges;
+	if (is_indexed)
+	{
+		candidate_vertices.swap(hovering_vertices);
+		candidate_edges.swap(hovering_edges);
+		const SpatialGrid::Cell* cell = grid.Find(
+			viewport_position.WorldX(window->GetMouseX()),
+			viewport_position.WorldY(window->GetMouseY()));
+		if (cell != nullptr)
+		{
+			candidate_vertices.insert(candidate_vertices.end(),
+				cell->vertices.begin(), cell->vertices.end());
+			candidate_edges.insert(candidate_edges.end(),
+				cell->edges.begin(), cell->edges.end());
+		}
+	}
+	else
+	{
+		grid.Clear();
+		for (Vertex* v : vertices)
+			grid.Insert(v);
+		for (Edge* e : edges)
+			grid.Insert(e);
+		candidate_vertices = vertices;
+		candidate_edges = edges;
+		is_indexed = true;
+	}
+
+	hovering_vertices.clear();
+	hovering_edges.clear();
+	for (Vertex* v : candidate_vertices)
+	{
+		if (v->CheckHovering())
+			window->Invalidate(v->Bounds()); // Show or hide its degree
+		if (v->IsHovering() && std::find(hovering_vertices.begin(),
+				hovering_vertices.end(), v) == hovering_vertices.end())
+			hovering_vertices.push_back(v);
+	}
+	for (Edge* e : candidate_edges)
+	{
+		e->CheckHovering();
+		if (e->IsHovering() && std::find(hovering_edges.begin(),
+				hovering_edges.end(), e) == hovering_edges.end())
+			hovering_edges.push_back(e);
+	}
+	hover_view_x = viewport_position.X();
+	hover_view_y = viewport_position.Y();
+	hover_zoom = viewport_position.Zoom();
+}
+
+void Graph::MoveVertex(Vertex& v, int x, int y)
+{
+	if (v.x == x && v.y == y) return;
+	std::vector<Edge*> incident_edges;
+	if (is_indexed)
+	{
+		// Edges start at their endpoints' centers, so all of v's edges are in
+		// the cell containing its center.
+		const SpatialGrid::Cell* cell = grid.Find(v.x, v.y);
+		if (cell != nullptr)
+			for (Edge* e : cell->edges)
+				if (e->HasEndpoint(v.id))
+					incident_edges.push_back(e);
+		for (Edge* e : incident_edges)
+			grid.Remove(e);
+		grid.Remove(&v);
+	}
+	v.x = x;
+	v.y = y;
+	if (is_indexed)
+	{
+		grid.Insert(&v);
+		for (Edge* e : incident_edges)
+			grid.Insert(e);
+		Edge::UpdateGeometry(incident_edges);
+	}
+	window->Invalidate(); // Its edges move with it.
+}
+
+void Graph::Attach(Vertex* v)
 {
-	vertices.push_back(v);
 	std::function<void()> f = [this, v] () {
 		RemoveVertex(v->id);
 	};
 	v->SetDeleteCallback(f);
+	v->SetChangeCallback([this, v] (gui::Color old_color,
+			gui::Color new_color) {
+		hash ^= Key(VERTEX_COLOR_KEY, v->id, old_color)
+			^ Key(VERTEX_COLOR_KEY, v->id, new_color);
+		Changed(v->Bounds());
+	});
+	hash ^= VertexKey(*v);
+}
+
+void Graph::Attach(Edge* e)
+{
+	e->SetDeleteCallback([this, e] () {
+		RemoveEdge(e->from.id, e->to.id);
+	});
+	e->SetChangeCallback([this, e] (gui::Color old_color,
+			gui::Color new_color) {
+		hash ^= EdgeColorKey(*e, directed, old_color)
+			^ EdgeColorKey(*e, directed, new_color);
+		Changed(e->Bounds());
+	});
+	hash ^= EdgeKey(*e, directed);
+}
+
+int Graph::AddVertex(Vertex* v)
+{
+	vertices.push_back(v);
+	Attach(v);
 	DFS();
+	Changed();
 	return v->id;
 }
 
@@ -247,17 +443,17 @@ int Graph::AddVertex(Vertex& v)
 
 int Graph::AddVertex(int x, int y)
 {
-	Vertex* v = new Vertex(window, Level::colors[0], x, y, viewport_position);
+	Vertex* v = new Vertex(context, window, context.colors[0], x, y,
+		viewport_position);
 	return AddVertex(v);
 }
 
 int Graph::AddEdge(Edge* e)
 {
 	edges.push_back(e);
-	e->SetDeleteCallback([this, e] () {
-		RemoveEdge(e->from.id, e->to.id);
-	});
+	Attach(e);
 	DFS();
+	Changed();
 	return e->id;
 }
 
@@ -272,8 +468,8 @@ int Graph::AddEdge(int id1, int id2)
 		utils::errors::Die("Trying to create edge with non-existent vertex.");
 	Vertex& v1 = GetVertexByID(id1);
 	Vertex& v2 = GetVertexByID(id2);
-	Edge* e = new Edge(window, v1, v2, Level::colors[0], viewport_position,
-		directed);
+	Edge* e = new Edge(context, window, v1, v2, context.colors[0],
+		viewport_position, directed);
 	return AddEdge(e);
 }
 
@@ -291,6 +487,7 @@ void Graph::RemoveVertex(int id)
 	{
 		if (edges[i]->from.id == id || edges[i]->to.id == id)
 		{
+			hash ^= EdgeKey(*edges[i], directed);
 			delete edges[i];
 			edges.erase(edges.begin() + i);
 			i--;
@@ -301,12 +498,14 @@ void Graph::RemoveVertex(int id)
 	{
 		if (vertices[i]->id == id)
 		{
+			hash ^= VertexKey(*vertices[i]);
 			delete vertices[i];
 			vertices.erase(vertices.begin()+i);
 			break;
 		}
 	}
 	DFS();
+	Changed();
 }
 
 void Graph::RemoveEdge(int id1, int id2)
@@ -315,6 +514,7 @@ void Graph::RemoveEdge(int id1, int id2)
 	{
 		if (edges[i]->HasEndpoints(id1, id2))
 		{
+			hash ^= EdgeKey(*edges[i], directed);
 			delete edges[i];
 			edges.erase(edges.begin() + i);
 			break;
@@ -322,6 +522,7 @@ void Graph::RemoveEdge(int id1, int id2)
 		}
 	}
 	DFS();
+	Changed();
 }
 
 int Graph::Degree(int id) const
@@ -335,6 +536,96 @@ int Graph::Degree(int id) const
 	return degree;
 }
 
+unsigned long Graph::Revision() const
+{
+	return revision;
+}
+
+uint64_t Graph::Hash() const
+{
+	return hash;
+}
+
+std::shared_ptr<const Graph::Snapshot> Graph::GetSnapshot() const
+{
+	if (snapshot && snapshot->revision == revision)
+		return snapshot;
+	std::shared_ptr<Snapshot> copy = std::make_shared<Snapshot>();
+	copy->revision = revision;
+	copy->hash = hash;
+	copy->directed = directed;
+	copy->origins = origins;
+	copy->vertices.reserve(vertices.size());
+	for (const Vertex* v : vertices)
+	{
+		copy->vertices.push_back({v->id, v->x, v->y, v->Color(),
+			v->is_color_protected, v->is_edge_protected,
+			v->is_delete_protected});
+	}
+	copy->edges.reserve(edges.size());
+	for (const Edge* e : edges)
+	{
+		copy->edges.push_back({e->id, e->from.id, e->to.id, e->Color(),
+			e->is_color_protected, e->is_delete_protected});
+	}
+	snapshot = copy;
+	return snapshot;
+}
+
+void Graph::Restore(const Snapshot& snapshot_)
+{
+	Clear();
+	directed = snapshot_.directed;
+	origins = snapshot_.origins;
+	// Elements are added directly, so the DFS only runs once.
+	std::map<int, Vertex*> vertex_by_id;
+	int next_vertex_id = 0, next_edge_id = 0;
+	for (const Snapshot::VertexData& data : snapshot_.vertices)
+	{
+		context.next_vertex_id = data.id;
+		Vertex* v = new Vertex(context, window, data.color, data.x, data.y,
+			viewport_position);
+		v->is_color_protected = data.is_color_protected;
+		v->is_edge_protected = data.is_edge_protected;
+		v->is_delete_protected = data.is_delete_protected;
+		vertices.push_back(v);
+		Attach(v);
+		vertex_by_id[data.id] = v;
+		next_vertex_id = std::max(next_vertex_id, data.id + 1);
+	}
+	for (const Snapshot::EdgeData& data : snapshot_.edges)
+	{
+		context.next_edge_id = data.id;
+		Edge* e = new Edge(context, window, *vertex_by_id.at(data.from),
+			*vertex_by_id.at(data.to), data.color, viewport_position, directed);
+		e->is_color_protected = data.is_color_protected;
+		e->is_delete_protected = data.is_delete_protected;
+		edges.push_back(e);
+		Attach(e);
+		next_edge_id = std::max(next_edge_id, data.id + 1);
+	}
+	context.next_vertex_id = next_vertex_id;
+	context.next_edge_id = next_edge_id;
+	DFS();
+	revision = snapshot_.revision;
+	snapshot = nullptr; // It may have had the same revision.
+}
+
+void Graph::Changed()
+{
+	revision++;
+	is_indexed = false;
+	hovering_vertices.clear();
+	hovering_edges.clear();
+	window->Invalidate();
+}
+
+void Graph::Changed(const gui::Rectangle& damage)
+{
+	revision++;
+	window->Invalidate(damage);
+}
+
 void Graph::DFS()
 {
 	std::stack<int> vertices;
@@ -372,9 +663,16 @@ bool Graph::IsConnected() const
 	return true;
 }
 
-void Graph::Render(const std::set<int>& edges_in_path,
-				   const std::set<int>& vertices_in_path, int last_vertex)
+void Graph::Render(const std::unordered_set<int>& edges_in_path,
+				   const std::unordered_set<int>& vertices_in_path,
+				   int last_vertex)
 {
+	utils::profiler::ScopedTimer timer("Graph::Render");
+	if (!is_indexed || hover_view_x != viewport_position.X()
+	 || hover_view_y != viewport_position.Y()
+	 || hover_zoom != viewport_position.Zoom())
+		MouseMoved(); // Everything has moved relative to the mouse.
+
 	// Display counter
 	window->SetTextSize(COUNTER_TEXT_SIZE);
 	window->SetDrawColor(0xCCCCCCFF);
@@ -397,11 +695,51 @@ void Graph::Render(const std::set<int>& edges_in_path,
 		}
 	}
 
-	for (Vertex* v : vertices)
-		v->Render(Degree(v->id), IsConnected(v->id) > 0,
-			vertices_in_path.count(v->id) > 0, last_vertex == v->id);
-	for (Edge* e : edges)
-		e->Render(edges_in_path.count(e->id) > 0);
+	// Only what's in view. The padding covers arrows and circles which
+	// stick out of their cells.
+	int pad = Vertex::VERTEX_RADIUS;
+	int x1 = viewport_position.WorldX(0) - pad;
+	int y1 = viewport_position.WorldY(0) - pad;
+	int x2 = viewport_position.WorldX(window->GetWidth()) + pad;
+	int y2 = viewport_position.WorldY(window->GetHeight()) + pad;
+	if (grid.QueryCost(x1, y1, x2, y2) < vertices.size() + edges.size())
+	{
+		grid.Query(x1, y1, x2, y2, visible_vertices, visible_edges);
+	}
+	else // Most of the graph is in view; checking everything is quicker.
+	{
+		visible_vertices.clear();
+		visible_edges.clear();
+		for (Vertex* v : vertices)
+			if (v->x >= x1 && v->x <= x2 && v->y >= y1 && v->y <= y2)
+				visible_vertices.push_back(v);
+		for (Edge* e : edges)
+			if (std::max(e->from.x, e->to.x) >= x1
+			 && std::min(e->from.x, e->to.x) <= x2
+			 && std::max(e->from.y, e->to.y) >= y1
+			 && std::min(e->from.y, e->to.y) <= y2)
+				visible_edges.push_back(e);
+	}
+
+	int radius = viewport_position.ScreenLength(Vertex::VERTEX_RADIUS);
+	if (radius < MIN_DETAILED_RADIUS)
+	{
+		RenderZoomedOut(edges_in_path, vertices_in_path, last_vertex, radius);
+	}
+	else
+	{
+		// Edges only meet the vertices' circles, so all of them can go in
+		// one batch.
+		window->BeginBatch();
+		// Degree is only shown when hovering, and it's O(E) to find.
+		for (Vertex* v : visible_vertices)
+			v->Render(v->IsHovering() ? Degree(v->id) : 0,
+				IsConnected(v->id) > 0, vertices_in_path.count(v->id) > 0,
+				last_vertex == v->id);
+		for (Edge* e : visible_edges)
+			e->Render(edges_in_path.count(e->id) > 0);
+		window->EndBatch();
+	}
 
 	for (Vertex* v : vertices)
 		v->RenderColorMenu();
@@ -409,11 +747,65 @@ void Graph::Render(const std::set<int>& edges_in_path,
 		e->RenderColorMenu();
 }
 
+void Graph::RenderZoomedOut(const std::unordered_set<int>& edges_in_path,
+	const std::unordered_set<int>& vertices_in_path, int last_vertex,
+	int radius)
+{
+	// Edges are drawn between the vertices' centers, without arrows. They go
+	// underneath the vertices.
+	window->BeginBatch();
+	for (const Edge* e : visible_edges)
+	{
+		window->SetDrawColor(edges_in_path.count(e->id) > 0
+			? gui::colors::WHITE : e->Color());
+		window->DrawLine(e->from.RenderX(), e->from.RenderY(),
+			e->to.RenderX(), e->to.RenderY());
+	}
+	window->EndBatch();
+
+	window->BeginBatch();
+	if (radius >= 1)
+	{
+		for (Vertex* v : visible_vertices)
+			v->Render(0, IsConnected(v->id) > 0,
+				vertices_in_path.count(v->id) > 0, last_vertex == v->id);
+		window->EndBatch();
+		return;
+	}
+
+	// Vertices smaller than a pixel are merged: each pixel is drawn once, in
+	// the color of the vertex which would be on top.
+	int width = window->GetWidth(), height = window->GetHeight();
+	if (is_covered.size() != (size_t)width * height)
+		is_covered.assign((size_t)width * height, false);
+	covered_pixels.clear();
+	for (auto it = visible_vertices.rbegin(); it != visible_vertices.rend();
+		it++)
+	{
+		const Vertex* v = *it;
+		int x = v->RenderX(), y = v->RenderY();
+		if (x < 0 || y < 0 || x >= width || y >= height
+		 || is_covered[y * width + x])
+			continue;
+		is_covered[y * width + x] = true;
+		covered_pixels.push_back(y * width + x);
+		gui::Color color = v->Color();
+		if (vertices_in_path.count(v->id) > 0)
+			color = gui::colors::WHITE;
+		if (last_vertex == v->id)
+			color = 0x888888FF;
+		window->SetDrawColor(color);
+		window->DrawPoint(x, y);
+	}
+	window->EndBatch();
+	for (int pixel : covered_pixels)
+		is_covered[pixel] = false;
+}
+
 void Graph::Render()
 {
-	std::set<int> edges_in_path;
-	std::set<int> vertices_in_path;
-	Render(edges_in_path, vertices_in_path, -1);
+	static const std::unordered_set<int> no_path;
+	Render(no_path, no_path, -1);
 }
 
 } // namespace graphcoloring
@@ -20,16 +20,44 @@
 #define GRAPHCOLORING_GRAPHS_GRAPH_H_
 
 #include <set>
+#include <unordered_set>
+#include <memory>
+#include <cstdint>
 
 #include "vertex.hpp"
 #include "edge.hpp"
+#include "spatialgrid.hpp"
 
 namespace graphcoloring {
 
 class Graph {
 public:
-	Graph(gui::Window* window, const gui::Position& viewport_position,
-		bool directed = false);
+	// An immutable copy of a graph, which can be read from any thread.
+	struct Snapshot
+	{
+		struct VertexData
+		{
+			int id;
+			int x, y;
+			gui::Color color;
+			bool is_color_protected, is_edge_protected, is_delete_protected;
+		};
+		struct EdgeData
+		{
+			int id;
+			int from, to; // Vertex IDs
+			gui::Color color;
+			bool is_color_protected, is_delete_protected;
+		};
+		unsigned long revision;
+		uint64_t hash;
+		bool directed;
+		std::vector<int> origins;
+		std::vector<VertexData> vertices;
+		std::vector<EdgeData> edges;
+	};
+	Graph(LevelContext& context, gui::Window* window,
+		const gui::Viewport& viewport_position, bool directed = false);
 	virtual ~Graph();
 	int V() const;
 	int E() const;
@@ -57,30 +85,64 @@ public:
 	int Degree(int id) const;
 	bool IsConnected(int id) const;
 	bool IsConnected() const;
-	void Render(const std::set<int>& edges_in_path,
-			    const std::set<int>& vertices_in_path, int last_vertex);
+	void Render(const std::unordered_set<int>& edges_in_path,
+			    const std::unordered_set<int>& vertices_in_path, int last_vertex);
 	void Render();
+	unsigned long Revision() const; // Changes whenever an element is added, removed or recolored.
+	uint64_t Hash() const; // Zobrist hash of the vertices, edges and their colors
+	std::shared_ptr<const Snapshot> GetSnapshot() const; // A full copy, shared until the revision changes.
+	void Restore(const Snapshot& snapshot); // Replace this graph with a copy of snapshot, keeping IDs.
 	bool can_add_new_vertices; // Can the user add more vertices?
 	bool can_add_new_edges;
 	std::vector<Vertex*> vertices;
 	std::vector<Edge*> edges;
 private:
-	static void ResetIDs(); // Reset edge and vertex IDs.
+	void ResetIDs(); // Reset edge and vertex IDs.
 	int AddVertex(Vertex* v);
 	int AddEdge(Edge* e);
+	void Attach(Vertex* v); // Set v's callbacks, and add it to the hash.
+	void Attach(Edge* e);
 	void EPressed(); // e key was pressed
 	void DFS(); // Run a DFS on the graph to see which vertices are connected
+	void MouseMoved(); // Moves the vertex being moved, and updates hovering.
+	void UpdateHovering();
+	void MoveVertex(Vertex& v, int x, int y);
+	void Changed(); // Something structural changed; redraw everything.
+	void RenderZoomedOut(const std::unordered_set<int>& edges_in_path,
+		const std::unordered_set<int>& vertices_in_path, int last_vertex,
+		int radius);
+	void Changed(const gui::Rectangle& damage); // Only damage needs redrawing
 	static constexpr int COUNTER_TEXT_SIZE = 24;
+	static constexpr int MIN_DETAILED_RADIUS = 4; // Vertex radius (in pixels) below which details are left out
+	LevelContext& context;
 	gui::Window* const window;
-	const gui::Position& viewport_position;
+	const gui::Viewport& viewport_position;
 	bool directed;
 	std::vector<int> origins;
 	std::set<int> connected;
 	bool is_locked = false;
+	unsigned long revision = 0;
+	uint64_t hash = 0;
+	mutable std::shared_ptr<const Snapshot> snapshot; // Last one taken, if any.
 
 	int edge_vertex; // First vertex in edge; -1 if not making edge.
 	int v_keyup_callback;
 	int e_keyup_callback;
+	int mousemotion_callback;
+	// Hovering is found with grid, which is built when it's first needed
+	// after a structural change, and updated as vertices move.
+	SpatialGrid grid;
+	bool is_indexed = false;
+	std::vector<Vertex*> hovering_vertices;
+	std::vector<Edge*> hovering_edges;
+	int hover_view_x = 0, hover_view_y = 0; // Viewport when hovering was updated
+	double hover_zoom = 1;
+	std::vector<Vertex*> visible_vertices; // Found with grid when rendering
+	std::vector<Edge*> visible_edges;
+	// For RenderZoomedOut: one per pixel of the window, all false between
+	// frames, and which of them were set this frame.
+	std::vector<bool> is_covered;
+	std::vector<int> covered_pixels;
 };
 
 } // namespace graphcoloring
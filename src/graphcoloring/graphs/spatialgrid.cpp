@@ -0,0 +1,204 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "spatialgrid.hpp"
+
+#include <algorithm>
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+namespace graphcoloring {
+
+namespace {
+
+// Distance from (x, y) to the line segment from (x1, y1) to (x2, y2).
+double SegmentDistance(double x, double y, double x1, double y1,
+	double x2, double y2)
+{
+	double dx = x2 - x1, dy = y2 - y1;
+	double length_squared = dx*dx + dy*dy;
+	double t = length_squared == 0 ? 0
+		: ((x - x1) * dx + (y - y1) * dy) / length_squared;
+	t = std::max(0.0, std::min(1.0, t));
+	return std::hypot(x - (x1 + t * dx), y - (y1 + t * dy));
+}
+
+} // namespace
+
+SpatialGrid::key_t SpatialGrid::Key(int cell_x, int cell_y)
+{
+	return ((key_t)(uint32_t)cell_x << 32) | (uint32_t)cell_y;
+}
+
+int SpatialGrid::CellCoordinate(int x)
+{
+	return x >= 0 ? x / CELL_SIZE : -((-x - 1) / CELL_SIZE) - 1;
+}
+
+void SpatialGrid::Insert(Vertex* v)
+{
+	std::vector<key_t>& keys = vertex_cells[v->id];
+	int r = Vertex::VERTEX_RADIUS;
+	int x1 = CellCoordinate(v->x - r), x2 = CellCoordinate(v->x + r);
+	int y1 = CellCoordinate(v->y - r), y2 = CellCoordinate(v->y + r);
+	for (int cx = x1; cx <= x2; cx++)
+	{
+		for (int cy = y1; cy <= y2; cy++)
+		{
+			keys.push_back(Key(cx, cy));
+			cells[keys.back()].vertices.push_back(v);
+		}
+	}
+	entries += keys.size();
+}
+
+void SpatialGrid::Insert(Edge* e)
+{
+	std::vector<key_t>& keys = edge_cells[e->id];
+	int pad = Edge::EDGE_CLICK_TOLERANCE;
+	int x1 = e->from.x, y1 = e->from.y, x2 = e->to.x, y2 = e->to.y;
+	// Only the cells in the bounding box which the segment actually passes
+	// near, so long diagonal edges don't fill up the grid.
+	double reach = CELL_SIZE * M_SQRT1_2 + pad;
+	for (int cx = CellCoordinate(std::min(x1, x2) - pad);
+		cx <= CellCoordinate(std::max(x1, x2) + pad); cx++)
+	{
+		for (int cy = CellCoordinate(std::min(y1, y2) - pad);
+			cy <= CellCoordinate(std::max(y1, y2) + pad); cy++)
+		{
+			double center_x = (cx + 0.5) * CELL_SIZE;
+			double center_y = (cy + 0.5) * CELL_SIZE;
+			if (SegmentDistance(center_x, center_y, x1, y1, x2, y2) > reach)
+				continue;
+			keys.push_back(Key(cx, cy));
+			cells[keys.back()].edges.push_back(e);
+		}
+	}
+	entries += keys.size();
+}
+
+template <typename T>
+void SpatialGrid::RemoveFrom(std::vector<T*>& elements, const T* element)
+{
+	auto it = std::find(elements.begin(), elements.end(), element);
+	if (it != elements.end())
+		elements.erase(it);
+}
+
+void SpatialGrid::Remove(const Vertex* v)
+{
+	auto it = vertex_cells.find(v->id);
+	if (it == vertex_cells.end()) return;
+	for (key_t key : it->second)
+	{
+		Cell& cell = cells[key];
+		RemoveFrom(cell.vertices, v);
+		if (cell.vertices.empty() && cell.edges.empty())
+			cells.erase(key);
+	}
+	entries -= it->second.size();
+	vertex_cells.erase(it);
+}
+
+void SpatialGrid::Remove(const Edge* e)
+{
+	auto it = edge_cells.find(e->id);
+	if (it == edge_cells.end()) return;
+	for (key_t key : it->second)
+	{
+		Cell& cell = cells[key];
+		RemoveFrom(cell.edges, e);
+		if (cell.vertices.empty() && cell.edges.empty())
+			cells.erase(key);
+	}
+	entries -= it->second.size();
+	edge_cells.erase(it);
+}
+
+void SpatialGrid::Clear()
+{
+	cells.clear();
+	vertex_cells.clear();
+	edge_cells.clear();
+	entries = 0;
+}
+
+const SpatialGrid::Cell* SpatialGrid::Find(int x, int y) const
+{
+	auto it = cells.find(Key(CellCoordinate(x), CellCoordinate(y)));
+	return it == cells.end() ? nullptr : &it->second;
+}
+
+double SpatialGrid::QueryCost(int x1, int y1, int x2, int y2) const
+{
+	if (cells.empty()) return 0;
+	double area = (double)(CellCoordinate(x2) - CellCoordinate(x1) + 1)
+		* (CellCoordinate(y2) - CellCoordinate(y1) + 1);
+	return entries * std::min(1.0, area / cells.size());
+}
+
+void SpatialGrid::Query(int x1, int y1, int x2, int y2,
+	std::vector<Vertex*>& vertices, std::vector<Edge*>& edges) const
+{
+	vertices.clear();
+	edges.clear();
+	int cx1 = CellCoordinate(x1), cx2 = CellCoordinate(x2);
+	int cy1 = CellCoordinate(y1), cy2 = CellCoordinate(y2);
+	auto add = [&] (const Cell& cell) {
+		vertices.insert(vertices.end(),
+			cell.vertices.begin(), cell.vertices.end());
+		edges.insert(edges.end(), cell.edges.begin(), cell.edges.end());
+	};
+	// When zoomed out, there are fewer occupied cells than cells in the
+	// rectangle, so go through those instead.
+	if ((double)(cx2 - cx1 + 1) * (cy2 - cy1 + 1) <= cells.size())
+	{
+		for (int cx = cx1; cx <= cx2; cx++)
+		{
+			for (int cy = cy1; cy <= cy2; cy++)
+			{
+				auto it = cells.find(Key(cx, cy));
+				if (it != cells.end())
+					add(it->second);
+			}
+		}
+	}
+	else
+	{
+		for (const auto& entry : cells)
+		{
+			int cx = (int32_t)(entry.first >> 32);
+			int cy = (int32_t)(uint32_t)entry.first;
+			if (cx >= cx1 && cx <= cx2 && cy >= cy1 && cy <= cy2)
+				add(entry.second);
+		}
+	}
+
+	auto by_id = [] (const auto* a, const auto* b) { return a->id < b->id; };
+	auto same_id = [] (const auto* a, const auto* b) {
+		return a->id == b->id;
+	};
+	std::sort(vertices.begin(), vertices.end(), by_id);
+	vertices.erase(std::unique(vertices.begin(), vertices.end(), same_id),
+		vertices.end());
+	std::sort(edges.begin(), edges.end(), by_id);
+	edges.erase(std::unique(edges.begin(), edges.end(), same_id),
+		edges.end());
+}
+
+} // namespace graphcoloring
@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_GRAPHS_SPATIALGRID_H_
+#define GRAPHCOLORING_GRAPHS_SPATIALGRID_H_
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "vertex.hpp"
+#include "edge.hpp"
+
+namespace graphcoloring {
+
+// A uniform grid of square cells over the plane (in world coordinates, so
+// panning doesn't affect it), so that finding the vertices and edges near a
+// point only means looking in one cell.
+class SpatialGrid {
+public:
+	struct Cell
+	{
+		std::vector<Vertex*> vertices; // Whose circles overlap this cell
+		std::vector<Edge*> edges; // Which pass within hovering distance
+	};
+	void Insert(Vertex* v);
+	void Insert(Edge* e);
+	void Remove(const Vertex* v); // Must be called before v moves.
+	void Remove(const Edge* e);
+	void Clear();
+	const Cell* Find(int x, int y) const; // nullptr if nothing is near (x, y)
+	// Everything in the cells overlapping the rectangle from (x1, y1) to
+	// (x2, y2), each once, sorted by ID.
+	void Query(int x1, int y1, int x2, int y2, std::vector<Vertex*>& vertices,
+		std::vector<Edge*>& edges) const;
+	// Roughly how many entries Query would go through (elements are in as
+	// many entries as cells they're in).
+	double QueryCost(int x1, int y1, int x2, int y2) const;
+	static constexpr int CELL_SIZE = 2 * Vertex::VERTEX_RADIUS;
+private:
+	typedef uint64_t key_t;
+	static key_t Key(int cell_x, int cell_y);
+	static int CellCoordinate(int x);
+	template <typename T>
+	static void RemoveFrom(std::vector<T*>& elements, const T* element);
+	std::unordered_map<key_t, Cell> cells;
+	// Which cells each vertex/edge is in, by ID.
+	std::unordered_map<int, std::vector<key_t>> vertex_cells, edge_cells;
+	size_t entries = 0;
+};
+
+} // namespace graphcoloring
+
+#endif // GRAPHCOLORING_GRAPHS_SPATIALGRID_H_
@@ -27,17 +27,10 @@
 
 namespace graphcoloring {
 
-int Vertex::id_counter = 0;
-int Vertex::moving_vertex = -1;
-
-void Vertex::ResetID()
-{
-	id_counter = 0;
-}
-
-Vertex::Vertex(gui::Window* window_, gui::Color color_, int x_, int y_,
-	const gui::Position& viewport_position_)
-	: x(x_), y(y_), id(id_counter++),
+Vertex::Vertex(LevelContext& context_, gui::Window* window_, gui::Color color_,
+	int x_, int y_, const gui::Viewport& viewport_position_)
+	: x(x_), y(y_), id(context_.next_vertex_id++),
+	  context(context_),
 	  window(window_),
 	  color(color_),
 	  viewport_position(viewport_position_),
@@ -50,7 +43,7 @@ Vertex::Vertex(gui::Window* window_, gui::Color color_, int x_, int y_,
 
 Vertex::~Vertex()
 {
-	if (moving_vertex == id) moving_vertex = -1;
+	if (context.moving_vertex == id) context.moving_vertex = -1;
 	window->RemoveMousedownCallback(mousedown_callback_id);
 	window->RemoveKeydownCallback(m_keydown_callback_id, GDK_KEY_m);
 	window->RemoveKeyupCallback(m_keyup_callback_id, GDK_KEY_m);
@@ -60,7 +53,7 @@ Vertex::~Vertex()
 void Vertex::Lock()
 {
 	is_locked = true;
-	moving_vertex = -1;
+	context.moving_vertex = -1;
 }
 
 void Vertex::Unlock()
@@ -81,14 +74,14 @@ void Vertex::SetMoveCallbacks()
 {
 	m_keydown_callback_id =
 		window->SetKeydownCallback([this] (gui::Window*) {
-			if (moving_vertex == -1 && hovering)
+			if (context.moving_vertex == -1 && hovering)
 			{
-				moving_vertex = id;
+				context.moving_vertex = id;
 			}
 		}, GDK_KEY_m);
 	m_keyup_callback_id =
 		window->SetKeyupCallback([this] (gui::Window*) {
-			moving_vertex = -1;
+			context.moving_vertex = -1;
 		}, GDK_KEY_m);
 }
 
@@ -106,11 +99,25 @@ void Vertex::SetDeleteKeyCallback()
 		}, GDK_KEY_x);
 }
 
+bool Vertex::CheckHovering()
+{
+	bool was_hovering = hovering;
+	hovering = utils::geometry::InCircle(
+		viewport_position.WorldX(window->GetMouseX()),
+		viewport_position.WorldY(window->GetMouseY()), x, y, VERTEX_RADIUS);
+	return hovering != was_hovering;
+}
+
 void Vertex::SetDeleteCallback(std::function<void()> delete_callback_)
 {
 	delete_callback = delete_callback_;
 }
 
+void Vertex::SetChangeCallback(change_callback_t change_callback_)
+{
+	change_callback = change_callback_;
+}
+
 bool Vertex::operator==(const Vertex other) const
 {
 	return id == other.id;
@@ -124,18 +131,32 @@ gui::Color Vertex::Color() const
 bool Vertex::ChangeColor(gui::Color new_color)
 {
 	if (is_color_protected) return false;
+	if (new_color != color && change_callback)
+		change_callback(color, new_color);
 	color = new_color;
 	return true;
 }
 
 int Vertex::RenderX() const
 {
-	return x - viewport_position.X();
+	return viewport_position.ScreenX(x);
 }
 
 int Vertex::RenderY() const
 {
-	return y - viewport_position.Y();
+	return viewport_position.ScreenY(y);
+}
+
+int Vertex::RenderRadius() const
+{
+	return viewport_position.ScreenLength(VERTEX_RADIUS);
+}
+
+gui::Rectangle Vertex::Bounds() const
+{
+	int r = RenderRadius();
+	return gui::Rectangle::Around(RenderX() - r, RenderY() - r,
+		RenderX() + r, RenderY() + r).Padded(BOUNDS_PADDING);
 }
 
 
@@ -143,36 +164,24 @@ void Vertex::Render(int degree, bool filled, bool is_in_path,
 	bool is_last_vertex)
 {
 	int rx = RenderX(), ry = RenderY(); // Coordinates of circle
-
-	CheckIfMoving();
+	int r = RenderRadius();
 
 	window->SetDrawColor(is_in_path ? gui::colors::WHITE : color);
 	if (is_last_vertex)
 		window->SetDrawColor(0x888888FF);
-	window->DrawCircle(rx, ry, VERTEX_RADIUS, filled);
-	window->SetTextSize(VERTEX_RADIUS*gui::Button::CIRCLE_TEXT_SIZE_FACTOR);
+	window->DrawCircle(rx, ry, r, filled);
+	window->SetTextSize(r*gui::Button::CIRCLE_TEXT_SIZE_FACTOR);
 
 	if (filled)
 		window->SetDrawColor(GraphColoring::BACKGROUND_COLOR);
 
-	hovering = utils::geometry::InCircle(
-		window->GetMouseX(), window->GetMouseY(), rx, ry, VERTEX_RADIUS);
-	if (hovering)
+	if (hovering && r >= MIN_DEGREE_TEXT_RADIUS)
 	{
 		window->DrawText(std::to_string(degree), gui::Position(rx,ry),
 			gui::Alignment::CENTER, gui::Alignment::CENTER);
 	}
 }
 
-void Vertex::CheckIfMoving()
-{
-	if (moving_vertex == id)
-	{
-		x = window->GetMouseX() + viewport_position.X();
-		y = window->GetMouseY() + viewport_position.Y();
-	}
-}
-
 void Vertex::RenderColorMenu()
 {
 	if (color_menu != nullptr)
@@ -190,8 +199,9 @@ void Vertex::MouseCallback(int mouse_x, int mouse_y)
 			color_menu = nullptr;
 		};
 
-		color_menu = std::make_unique<ColorMenu>(window,
-			mouse_x+viewport_position.X(), mouse_y+viewport_position.Y(),
+		color_menu = std::make_unique<ColorMenu>(context, window,
+			viewport_position.WorldX(mouse_x),
+			viewport_position.WorldY(mouse_y),
 			viewport_position, callback);
 
 		std::function<void()> close_callback = [this] () {
@@ -20,45 +20,53 @@
 #define GRAPHCOLORING_GRAPHS_VERTEX_H_
 
 #include "gui/colors.hpp"
+#include "gui/viewport.hpp"
 #include "gui/window.hpp"
 #include "colormenu.hpp"
+#include "../levelcontext.hpp"
 
 namespace graphcoloring {
 
 class Vertex {
 public:
-	static void ResetID();
-	Vertex(gui::Window* window, gui::Color color, int x, int y,
-		const gui::Position& viewport_position);
+	typedef std::function<void(gui::Color old_color, gui::Color new_color)>
+		change_callback_t;
+	Vertex(LevelContext& context, gui::Window* window, gui::Color color,
+		int x, int y, const gui::Viewport& viewport_position);
 	virtual ~Vertex();
 	void Lock();
 	void Unlock();
 	void SetDeleteCallback(std::function<void()> delete_callback);
+	void SetChangeCallback(change_callback_t change_callback); // Called when the color changes
 	bool operator==(const Vertex other) const;
 	gui::Color Color() const;
 	bool ChangeColor(gui::Color new_color);
 	int RenderX() const; // x-position when rendered
 	int RenderY() const;
+	int RenderRadius() const;
 	bool IsHovering() const { return hovering; }; // Is the mouse hovering over this vertex?
+	gui::Rectangle Bounds() const; // Area covered when rendered
+	bool CheckHovering(); // Returns true if hovering changed.
 	void Render(int degree, bool filled = false, bool is_in_path = false,
 		bool is_last_vertex = false);
 	void RenderColorMenu();
 	static constexpr int VERTEX_RADIUS = 40;
+	static constexpr int BOUNDS_PADDING = 4; // Room for line widths
+	static constexpr int MIN_DEGREE_TEXT_RADIUS = 8; // Smaller vertices don't show their degree
 	int x;
 	int y;
 	const int id;
 	bool is_color_protected = false;
 	bool is_edge_protected = false;
 	bool is_delete_protected = false;
-	static int moving_vertex; // id of vertex that is being moved, or -1 if no vertex is being moved.
 private:
 	void SetClickCallback();
 	void SetMoveCallbacks();
 	void SetDeleteKeyCallback();
 	void MouseCallback(int mouse_x, int mouse_y);
-	void CheckIfMoving();
-	static int id_counter;
+	LevelContext& context;
 	std::function<void()> delete_callback;
+	change_callback_t change_callback;
 	int mousedown_callback_id;
 	int m_keydown_callback_id;
 	int m_keyup_callback_id;
@@ -67,7 +75,7 @@ private:
 	gui::Color color;
 	bool hovering = false;
 	bool is_locked = false;
-	const gui::Position& viewport_position;
+	const gui::Viewport& viewport_position;
 	std::unique_ptr<ColorMenu> color_menu;
 };
 
@@ -19,15 +19,18 @@
 #include "level.hpp"
 
 #include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
 
 #include "graphcoloring.hpp"
 #include "graphs/vertex.hpp"
 #include "graphs/edge.hpp"
 #include "levels/graphloader.hpp"
+#include "utils/profiler.hpp"
 
 namespace graphcoloring {
 
-std::vector<gui::Color> Level::colors;
 
 pugi::xml_node Level::GetLevelNode(
 		const pugi::xml_document& document, std::string category_id,
@@ -43,16 +46,32 @@ pugi::xml_node Level::GetLevelNode(
 }
 
 Level::Level(gui::Window* window_,
-	std::string category_id_, std::string level_id_)
-	: window(window_), category_id(category_id_), level_id(level_id_),
-	  graph(window, viewport_position),
+	std::string category_id_, std::string level_id_, bool can_save_)
+	: window(window_), can_save(can_save_),
+	  category_id(category_id_), level_id(level_id_),
+	  graph(context, window, viewport_position),
+	  color_loader(context),
 	  path(window, graph, rule_loader, color_loader),
-	  point_calculator(value_loader, rule_loader, color_loader, path)
+	  point_calculator(value_loader, rule_loader, color_loader, path),
+	  score_worker(value_loader, rule_loader, point_calculator,
+		[this] () { window->Invalidate(points_area); }),
+	  hint_search(rule_loader, point_calculator, context.colors,
+		[this] () { window->Invalidate(); }),
+	  header_layer(window, [this] (gui::Window*) { RenderHeader(); }),
+	  rules_layer(window, [this] (gui::Window*) {
+		rule_loader.RenderRules(window);
+	  }),
+	  color_points_layer(window, [this] (gui::Window*) {
+		color_loader.RenderColorPoints(window);
+	  })
 {
 
 	window->SetRenderCallback([this] (gui::Window*){ Render(); });
 	window->SetKeyupCallback([this] (gui::Window*){ ResetViewport(); },
 		GDK_KEY_o);
+	window->SetScrollCallback([this] (gui::Window*, GdkScrollDirection d) {
+		Zoom(d);
+	});
 	window->SetKeyupCallback([this] (gui::Window*) {
 		if (window->IsControlDown())
 			Reset();
@@ -76,6 +95,7 @@ Level::Level(gui::Window* window_,
 
 Level::~Level()
 {
+	window->SetContinuous(false);
 	Save();
 }
 
@@ -121,8 +141,18 @@ void Level::LoadLevelDocument()
 
 	pugi::xml_node level_node = document.child("level");
 	title = level_node.attribute("title").value();
-	description = level_node.attribute("description").value();
+	std::string description = level_node.attribute("description").value();
 	objective = level_node.attribute("objective").value();
+	description_lines.clear();
+	size_t semicolon_index;
+	do { // Read description lines
+		semicolon_index = description.find(';');
+		description_lines.push_back(description.substr(0, semicolon_index));
+		description.erase(0, semicolon_index+1);
+	} while (semicolon_index != std::string::npos);
+	header_height = 50 + TITLE_SIZE + 10
+		+ (DESCRIPTION_SIZE + 10) * description_lines.size()
+		+ OBJECTIVE_SIZE + 10;
 
 	color_loader.LoadDocument(document);
 	global_loader.LoadDocument(document);
@@ -134,8 +164,16 @@ void Level::LoadLevelDocument()
 	value_loader.LoadGraph(graph_loader);
 	value_loader.LoadColors(color_loader);
 	value_loader.LoadDocument(document);
+	if (ValueLoader::dump_values)
+	{
+		std::cout << filename << ":" << std::endl;
+		value_loader.Dump(std::cout);
+	}
 	rule_loader.LoadDocument(document, color_loader);
 	path.LoadFromDocument(document);
+	header_layer.Invalidate();
+	rules_layer.Invalidate();
+	color_points_layer.Invalidate();
 
 	Load(); // Check for save file
 
@@ -152,6 +190,7 @@ void Level::Reset()
 	pugi::xml_document document;
 	std::string filename = GetFile();
 	document.load_file(filename.c_str());
+	path.ResetPath(); // The path's edges are about to be deleted.
 	graph.Clear();
 	GraphLoader graph_loader(color_loader, global_loader);
 	graph_loader.LoadDocument(document, graph);
@@ -179,12 +218,20 @@ void Level::GetBestPoints()
 
 void Level::Render()
 {
+	utils::profiler::ScopedTimer timer("Level::Render");
 	MoveViewport();
 
 	window->SetDrawColor(GraphColoring::BACKGROUND_COLOR);
 	window->Clear();
 	graph.Render(path.PathEdgeSet(), path.PathVertexSet(), path.LastVertex());
+	header_layer.Render();
+	RenderPoints(header_height);
+	RenderRules();
+	RenderHint();
+}
 
+void Level::RenderHeader()
+{
 	window->SetDrawColor(TEXT_COLOR);
 
 	int y = 50;
@@ -194,41 +241,55 @@ void Level::Render()
 
 	y += TITLE_SIZE + 10;
 	window->SetTextSize(DESCRIPTION_SIZE);
-	std::string description_text = description;
-	size_t semicolon_index;
-	do { // Read description lines
-		semicolon_index = description_text.find(';');
-		std::string line = description_text.substr(0, semicolon_index);
+	for (const std::string& line : description_lines)
+	{
 		window->DrawText(line, gui::Position(window->GetWidth()/2, y),
 				gui::Alignment::CENTER, gui::Alignment::TOP);
-		description_text.erase(0, semicolon_index+1);
 		y += DESCRIPTION_SIZE + 10;
-	} while (semicolon_index != std::string::npos);
+	}
 
 	window->SetTextSize(OBJECTIVE_SIZE);
 	window->DrawText(objective, gui::Position(window->GetWidth()/2, y),
 			gui::Alignment::CENTER, gui::Alignment::TOP);
-
-	y += OBJECTIVE_SIZE + 10;
-	RenderPoints(y);
-	RenderRules();
 }
 
 void Level::RenderPoints(int y)
 {
 	if (window->IsKeyDown(GDK_KEY_p) && !window->IsControlDown())
 	{
-		color_loader.RenderColorPoints(window);
+		color_points_layer.Render();
 		return;
 	}
+	points_area = gui::Rectangle{0, y, window->GetWidth(),
+		PRESS_ESC_SIZE + POINTS_SIZE + 20};
+
+	// Scoring is done by score_worker; show its latest result until the
+	// result for this revision comes in.
+	score_worker.Submit(graph.GetSnapshot());
+	const ScoreWorker::Result& score = score_worker.Latest();
+	if (!score.done) return;
+	bool is_current = score.revision == graph.Revision();
+	if (stale_revision != graph.Revision())
+	{
+		stale_revision = graph.Revision();
+		stale_since = std::chrono::steady_clock::now();
+	}
+	bool is_stale = !is_current && std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - stale_since).count() > STALE_DELAY;
+	if (!is_current && !is_stale)
+		window->Invalidate(points_area); // Until it's marked as stale
 
-	bool is_valid = rule_loader.IsValid(graph);
-	int points = GetPoints();
-	int objective = value_loader.ObjectivePoints(graph);
+	bool is_valid = score.is_valid;
+	int invalid_points = score.points + path.Points();
+	int points = is_valid ? invalid_points : 0;
+	int objective = score.objective;
 
-	GetBestPoints();
-	if (!has_loaded_best || points > best_points)
-		Save(SLOT_BEST);
+	if (is_current && can_save)
+	{
+		GetBestPoints();
+		if (!has_loaded_best || points > best_points)
+			Save(SLOT_BEST, points, objective);
+	}
 
 	if (points >= objective && is_valid)
 	{
@@ -239,12 +300,15 @@ void Level::RenderPoints(int y)
 				gui::Alignment::CENTER, gui::Alignment::TOP);
 		y += PRESS_ESC_SIZE + 10;
 	}
-	if (!is_valid)
+	if (is_stale)
+		window->SetDrawColor(STALE_COLOR);
+	else if (!is_valid)
 		window->SetDrawColor(INVALID_COLOR);
 
 	std::stringstream points_text;
-	int invalid_points = GetPoints(false);
 	points_text << "Points: " << invalid_points << "/" << objective;
+	if (is_stale)
+		points_text << " (updating)";
 	window->SetTextSize(POINTS_SIZE);
 	window->DrawText(points_text.str(), gui::Position(window->GetWidth()/2, y),
 			gui::Alignment::CENTER, gui::Alignment::TOP);
@@ -253,26 +317,99 @@ void Level::RenderPoints(int y)
 void Level::RenderRules()
 {
 	if (!window->IsKeyDown(GDK_KEY_r) || window->IsControlDown()) return;
-	rule_loader.RenderRules(window);
+	rules_layer.Render();
+}
+
+void Level::RenderHint()
+{
+	if (!window->IsKeyDown(GDK_KEY_h) || window->IsControlDown())
+	{
+		hint_search.Pause(); // It carries on from here next time.
+		return;
+	}
+	// Progress is posted back as it's made, which redraws the window.
+	hint_search.Submit(graph.GetSnapshot());
+	unsigned long revision = graph.Revision();
+
+	const solvers::HintSearch::Hint& hint = hint_search.Best();
+	std::stringstream hint_text;
+	if (!hint_search.IsStale(revision) && hint.found)
+	{
+		window->SetDrawColor(hint.color);
+		if (hint.is_vertex)
+		{
+			const Vertex& v = graph.GetVertexByID(hint.id);
+			window->DrawCircle(v.RenderX(), v.RenderY(),
+				v.RenderRadius() + 10, false);
+		}
+		else
+		{
+			const Edge& e = graph.GetEdgeByID(hint.id);
+			window->DrawCircle((e.from.RenderX() + e.to.RenderX()) / 2,
+				(e.from.RenderY() + e.to.RenderY()) / 2, 15);
+		}
+		hint_text << "Hint: make the circled "
+			<< (hint.is_vertex ? "vertex " : "edge ")
+			<< color_loader.GetColorName(hint.color) << " (";
+		if (hint.fixes_rules)
+			hint_text << hint.gain << " fewer rule violation"
+				<< (hint.gain == 1 ? "" : "s") << ")";
+		else
+			hint_text << "+" << hint.gain << " points)";
+	}
+	else if (hint_search.IsFinished(revision))
+	{
+		hint_text << "No hints found.";
+	}
+	else
+	{
+		hint_text << "Looking for a hint... "
+			<< (int)(100 * hint_search.Progress(revision)) << "%";
+	}
+	window->SetDrawColor(TEXT_COLOR);
+	window->SetTextSize(HINT_SIZE);
+	window->DrawText(hint_text.str(),
+		gui::Position(window->GetWidth()/2, window->GetHeight() - 10),
+		gui::Alignment::CENTER, gui::Alignment::BOTTOM);
 }
 
 void Level::MoveViewport()
 {
+	int speed = std::max(1,
+		(int)std::round(VIEW_MOVE_SPEED / viewport_position.Zoom()));
 	if (window->IsKeyDown(GDK_KEY_Up))
-		viewport_position.y -= VIEW_MOVE_SPEED;
+		viewport_position.y -= speed;
 	if (window->IsKeyDown(GDK_KEY_Down))
-		viewport_position.y += VIEW_MOVE_SPEED;
+		viewport_position.y += speed;
 
 	if (window->IsKeyDown(GDK_KEY_Left))
-		viewport_position.x -= VIEW_MOVE_SPEED;
+		viewport_position.x -= speed;
 	if (window->IsKeyDown(GDK_KEY_Right))
-		viewport_position.x += VIEW_MOVE_SPEED;
+		viewport_position.x += speed;
 
+	// Keep redrawing while the view is moving.
+	window->SetContinuous(window->IsKeyDown(GDK_KEY_Up)
+		|| window->IsKeyDown(GDK_KEY_Down) || window->IsKeyDown(GDK_KEY_Left)
+		|| window->IsKeyDown(GDK_KEY_Right));
 }
 
 void Level::ResetViewport()
 {
 	viewport_position.SetPos(0, 0);
+	viewport_position.SetZoom(1);
+}
+
+void Level::Zoom(GdkScrollDirection direction)
+{
+	double zoom = viewport_position.Zoom();
+	if (direction == GDK_SCROLL_UP)
+		zoom *= ZOOM_FACTOR;
+	else if (direction == GDK_SCROLL_DOWN)
+		zoom /= ZOOM_FACTOR;
+	else
+		return;
+	viewport_position.ZoomAround(zoom, window->GetMouseX(),
+		window->GetMouseY());
 }
 
 std::string Level::SaveFilename(int slot) const
@@ -291,9 +428,23 @@ std::string Level::SaveFilename(int slot) const
 
 void Level::Save(int slot)
 {
+	if (!can_save) return;
+	// Use score_worker's result if it's up to date, rather than scoring the
+	// graph again here.
+	const ScoreWorker::Result& score = score_worker.Latest();
+	if (score.done && score.revision == graph.Revision())
+		Save(slot, score.is_valid ? score.points + path.Points() : 0,
+			score.objective);
+	else
+		Save(slot, GetPoints(), value_loader.ObjectivePoints(graph));
+}
+
+void Level::Save(int slot, int points, int objective)
+{
+	utils::profiler::ScopedTimer timer("Level::Save");
 	pugi::xml_document document;
 	pugi::xml_node graph_node = document.append_child("graph");
-	graph_node.append_attribute("points") = GetPoints();
+	graph_node.append_attribute("points") = points;
 	GraphLoader graph_loader(color_loader, global_loader);
 	graph_loader.WriteGraph(graph, graph_node);
 	document.save_file(SaveFilename(slot).c_str());
@@ -301,15 +452,23 @@ void Level::Save(int slot)
 	if (slot == SLOT_BEST)
 	{
 		has_loaded_best = false;
-		UpdateLevelList();
+		UpdateLevelList(points, objective);
 	}
 }
 
+void Level::WaitForScore()
+{
+	score_worker.Submit(graph.GetSnapshot());
+	score_worker.Wait();
+}
+
 int Level::Load(int slot)
 {
+	utils::profiler::ScopedTimer timer("Level::Load");
 	pugi::xml_document document;
 	if (document.load_file(SaveFilename(slot).c_str()))
 	{
+		path.ResetPath();
 		graph.Clear();
 		GraphLoader graph_loader(color_loader, global_loader);
 		graph_loader.LoadDocument(document, graph);
@@ -321,14 +480,11 @@ int Level::Load(int slot)
 	}
 }
 
-void Level::UpdateLevelList()
+void Level::UpdateLevelList(int points, int objective)
 {
 	pugi::xml_document category_listing;
 	category_listing.load_file(LevelSelect::LEVEL_LISTING_PATH);
 
-	int points = GetPoints();
-	int objective = value_loader.ObjectivePoints(graph);
-
 	pugi::xml_node node = GetLevelNode(category_listing, category_id, level_id);
 
 	if (node.attribute("points").empty())
@@ -22,13 +22,18 @@
 
 #include <string>
 #include <memory>
+#include <chrono>
 
+#include "gui/layer.hpp"
 #include "gui/window.hpp"
+#include "levelcontext.hpp"
 #include "graphs/graph.hpp"
 #include "levels/globalloader.hpp"
 #include "levels/valueloader.hpp"
 #include "levels/rules/ruleloader.hpp"
 #include "levels/pointcalculator.hpp"
+#include "levels/scoreworker.hpp"
+#include "solvers/hintsearch.hpp"
 
 namespace graphcoloring {
 
@@ -37,46 +42,59 @@ public:
 	static pugi::xml_node GetLevelNode(
 		const pugi::xml_document& document, std::string category_id,
 		std::string level_id);
-	Level(gui::Window* window, std::string category_id, std::string level_id);
+	// If can_save is false, saves are still loaded but nothing is ever
+	// written (for benchmarks).
+	Level(gui::Window* window, std::string category_id, std::string level_id,
+		bool can_save = true);
 	virtual ~Level();
 	std::pair<std::string,std::string> NextLevel() const; // Returns <"", ""> on success.
 	void Render();
 	void Save(int slot = SLOT_RECENT);
 	int Load(int slot = SLOT_RECENT); // Returns 1 on success, 0 on failure
-	static std::vector<gui::Color> colors;
+	void WaitForScore(); // Blocks until the graph as it is now has been scored.
 private:
 	void LoadLevelDocument();
 	std::string GetFile();
 	void Reset();
 	void MoveViewport();
 	void ResetViewport();
+	void Zoom(GdkScrollDirection direction); // Zooms around the mouse
 	int GetPoints(bool check_if_invalid = true) const;
 	void GetBestPoints();
+	void RenderHeader(); // Title, description and objective
 	void RenderPoints(int y);
 	void RenderRules();
+	void RenderHint(); // Hold H to see a hint
 	std::string SaveFilename(int slot = SLOT_RECENT) const;
-	void UpdateLevelList();
-	static constexpr int VIEW_MOVE_SPEED = 5;
+	void Save(int slot, int points, int objective);
+	void UpdateLevelList(int points, int objective);
+	static constexpr int VIEW_MOVE_SPEED = 5; // Pixels per frame, at any zoom
+	static constexpr double ZOOM_FACTOR = 1.25; // Per step of the scroll wheel
 	static constexpr int TITLE_SIZE = 48;
 	static constexpr int DESCRIPTION_SIZE = 18;
 	static constexpr int OBJECTIVE_SIZE = 32;
 	static constexpr int POINTS_SIZE = 36;
 	static constexpr int PRESS_ESC_SIZE = 18;
+	static constexpr int HINT_SIZE = 24;
+	static constexpr double STALE_DELAY = 0.25; // Seconds before an old score is marked as stale
 	static constexpr gui::Color TEXT_COLOR = 0xDDDDDDFF;
 	static constexpr gui::Color SUCCESS_COLOR = gui::colors::GREEN;
 	static constexpr gui::Color INVALID_COLOR = gui::colors::RED;
+	static constexpr gui::Color STALE_COLOR = 0x888888FF;
 	static constexpr int SLOT_RECENT = -2;
 	static constexpr int SLOT_BEST   = -1;
 
 	gui::Window* const window;
+	const bool can_save;
 	int best_points = 0;
 	bool has_loaded_best = false;
-	gui::Position viewport_position;
+	gui::Viewport viewport_position;
 	std::string category_id;
 	std::string level_id;
 	std::string title;
-	std::string description;
+	std::vector<std::string> description_lines;
 	std::string objective;
+	LevelContext context;
 	Graph graph;
 	ColorLoader color_loader;
 	GlobalLoader global_loader;
@@ -84,6 +102,15 @@ private:
 	RuleLoader rule_loader;
 	Path path;
 	PointCalculator point_calculator;
+	ScoreWorker score_worker;
+	std::chrono::steady_clock::time_point stale_since; // When the graph last changed
+	unsigned long stale_revision = 0;
+	gui::Rectangle points_area{0, 0, 0, 0}; // Where the score was last drawn
+	solvers::HintSearch hint_search; // Searches while H is held.
+	int header_height = 0;
+	gui::Layer header_layer;
+	gui::Layer rules_layer; // Shown while R is held
+	gui::Layer color_points_layer; // Shown while P is held
 };
 
 } // namespace graphcoloring
@@ -0,0 +1,43 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_LEVELCONTEXT_H_
+#define GRAPHCOLORING_LEVELCONTEXT_H_
+
+#include <vector>
+
+#include "gui/colors.hpp"
+
+namespace graphcoloring {
+
+// State shared by everything in one level: its graph, the graph's vertices,
+// edges and color menus, and its loaders. Each level has its own, and it's
+// passed to them explicitly, so any number of levels can be loaded at once,
+// on any threads (as long as each level stays on one thread).
+struct LevelContext
+{
+	std::vector<gui::Color> colors; // The level's palette, filled in by ColorLoader
+	int next_vertex_id = 0;
+	int next_edge_id = 0;
+	int moving_vertex = -1; // ID of the vertex being moved, or -1 if no vertex is being moved.
+	int number_of_color_menus = 0; // Number of color menus open.
+};
+
+} // namespace graphcoloring
+
+#endif // GRAPHCOLORING_LEVELCONTEXT_H_
@@ -19,18 +19,18 @@
 #include "colorloader.hpp"
 
 #include "utils/errors.hpp"
-#include "../level.hpp"
 #include "../graphcoloring.hpp"
 
 namespace graphcoloring {
 
-ColorLoader::ColorLoader()
+ColorLoader::ColorLoader(LevelContext& context_)
+	: context(context_)
 {
 }
 
 void ColorLoader::LoadDocument(const pugi::xml_document& document)
 {
-	Level::colors.clear();
+	context.colors.clear();
 	pugi::xml_node colors_node = document.child("colors");
 	for (pugi::xml_node color_node : colors_node.children("color"))
 	{
@@ -42,10 +42,15 @@ void ColorLoader::LoadDocument(const pugi::xml_document& document)
 		color_names[name] = color;
 		vertex_color_points[color] = vertex_points;
 		edge_color_points[color] = edge_points;
-		Level::colors.push_back(color);
+		context.colors.push_back(color);
 	}
 }
 
+const std::vector<gui::Color>& ColorLoader::Colors() const
+{
+	return context.colors;
+}
+
 gui::Color ColorLoader::GetColorByName(std::string name) const
 {
 	if (color_names.count(name) == 0)
@@ -56,7 +61,7 @@ gui::Color ColorLoader::GetColorByName(std::string name) const
 gui::Color ColorLoader::GetColorFromAttribute(pugi::xml_attribute attr) const
 {
 	if (attr.empty())
-		return Level::colors[0];
+		return context.colors[0];
 	else
 		return GetColorByName(attr.value());
 }
@@ -90,7 +95,7 @@ void ColorLoader::RenderColorPoints(gui::Window* window) const
 	window->Clear();
 	int x = 10, y = 10;
 	const int w = COLOR_POINTS_COLUMN_WIDTH, h = Vertex::VERTEX_RADIUS * 2;
-	for (gui::Color color : Level::colors)
+	for (gui::Color color : context.colors)
 	{
 		if (edge_color_points.at(color) == 0) continue;
 		RenderEdgeColorPoints(window, color, x, y);
@@ -101,7 +106,7 @@ void ColorLoader::RenderColorPoints(gui::Window* window) const
 			x += w + 10;
 		}
 	}
-	for (gui::Color color : Level::colors)
+	for (gui::Color color : context.colors)
 	{
 		if (vertex_color_points.at(color) == 0) continue;
 		RenderVertexColorPoints(window, color, x, y);
@@ -24,14 +24,16 @@
 
 #include "gui/window.hpp"
 #include "pugi/pugixml.hpp"
+#include "../levelcontext.hpp"
 
 namespace graphcoloring {
 
 class ColorLoader {
 public:
-	ColorLoader();
+	ColorLoader(LevelContext& context);
 	virtual ~ColorLoader(){}
-	void LoadDocument(const pugi::xml_document& document);
+	void LoadDocument(const pugi::xml_document& document); // Fills in the context's colors.
+	const std::vector<gui::Color>& Colors() const; // In the order they were defined
 	gui::Color GetColorByName(std::string name) const;
 	gui::Color GetColorFromAttribute(pugi::xml_attribute attr) const;
 	std::string GetColorName(gui::Color color) const;
@@ -43,6 +45,7 @@ public:
 	std::map<gui::Color, int> edge_color_points;
 private:
 	static constexpr int COLOR_POINTS_COLUMN_WIDTH = 200;
+	LevelContext& context;
 	void RenderVertexColorPoints(gui::Window* window, gui::Color color,
 		int x, int y) const;
 	void RenderEdgeColorPoints(gui::Window* window, gui::Color color,
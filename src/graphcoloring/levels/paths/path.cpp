@@ -19,7 +19,8 @@
 #include "path.hpp"
 
 #include <cassert>
-#include <algorithm>
+
+#include "utils/profiler.hpp"
 
 namespace graphcoloring {
 
@@ -103,6 +104,7 @@ void Path::RightClick()
 		last_vertex = vertex_id;
 		if (first_vertex == -1)
 			first_vertex = vertex_id;
+		VisitVertex(vertex_id);
 		return;
 	}
 	if (last_vertex == vertex_id) // Remove end of path
@@ -112,56 +114,94 @@ void Path::RightClick()
 			ResetPath();
 			return;
 		}
-		int edge_id = path.at(path.size()-1);
-		path.pop_back();
-		last_vertex =
-			graph.GetEdgeByIDConst(edge_id).OtherEndpoint(last_vertex);
+		PopEdge();
 		return;
 	}
 	if (!graph.HasEdge(last_vertex, vertex_id))
 	{
 		return;
 	}
-	int edge_id = graph.GetEdgeByEndpointsConst(last_vertex, vertex_id).id;
-	if (std::find(path.begin(), path.end(), edge_id) != path.end()) // Duplicate edge
+	const Edge& edge = graph.GetEdgeByEndpointsConst(last_vertex, vertex_id);
+	if (path_edges.count(edge.id)) // Duplicate edge
 		return;
-	path.push_back(edge_id);
+	AppendEdge(edge, vertex_id);
+}
+
+void Path::AppendEdge(const Edge& edge, int vertex_id)
+{
+	int points = points_history.empty() ? points_starting_value
+	                                    : points_history.back();
+	points_history.push_back(ApplyOperations(points, edge.Color()));
+	path.push_back(edge.id);
+	path_edges.insert(edge.id);
+	VisitVertex(vertex_id);
 	last_vertex = vertex_id;
 }
 
+void Path::PopEdge()
+{
+	int edge_id = path.back();
+	path.pop_back();
+	points_history.pop_back();
+	path_edges.erase(edge_id);
+	LeaveVertex(last_vertex);
+	last_vertex = graph.GetEdgeByIDConst(edge_id).OtherEndpoint(last_vertex);
+}
+
+void Path::VisitVertex(int vertex_id)
+{
+	if (vertex_visits[vertex_id]++ == 0)
+		path_vertices.insert(vertex_id);
+}
+
+void Path::LeaveVertex(int vertex_id)
+{
+	if (--vertex_visits[vertex_id] == 0)
+	{
+		vertex_visits.erase(vertex_id);
+		path_vertices.erase(vertex_id);
+	}
+}
+
+int Path::ApplyOperations(int points, gui::Color edge_color) const
+{
+	auto color_operation = color_operations.find(edge_color);
+	if (color_operation != color_operations.end() && color_operation->second)
+		points = color_operation->second(points);
+
+	auto any_operation = color_operations.find(ANY_COLOR);
+	if (any_operation != color_operations.end() && any_operation->second)
+		points = any_operation->second(points);
+	return points;
+}
+
 void Path::ResetPath()
 {
 	if (!IsPath()) return;
 	graph.Unlock();
-	path = std::vector<int>();
+	path.clear();
+	points_history.clear();
+	path_edges.clear();
+	path_vertices.clear();
+	vertex_visits.clear();
 	is_making_path = false;
 	first_vertex = -1;
 	last_vertex = -1;
 }
 
-std::vector<int> Path::GetPath() const
+const std::vector<int>& Path::GetPath() const
 {
 	return path;
 }
 
-std::set<int> Path::PathEdgeSet() const
+const std::unordered_set<int>& Path::PathEdgeSet() const
 {
-	return std::set<int>(path.begin(), path.end());
-
+	return path_edges;
 }
 
-std::set<int> Path::PathVertexSet() const
+const std::unordered_set<int>& Path::PathVertexSet() const
 {
-	std::set<int> vertices;
-	if (last_vertex != -1)
-		vertices.insert(last_vertex);
-	for (int e : path)
-	{
-		const Edge& edge = graph.GetEdgeByIDConst(e);
-		vertices.insert(edge.from.id);
-		vertices.insert(edge.to.id);
-	}
-	return vertices;
+	return path_vertices;
 }
 
 int Path::LastVertex() const
@@ -181,6 +221,7 @@ bool Path::IsPath() const
 
 int Path::Points() const
 {
+	utils::profiler::ScopedTimer timer("Path::Points");
 	if (!IsPath()) return 0;
 	if (type == Type::CYCLE)
 	{
@@ -189,19 +230,40 @@ int Path::Points() const
 		if (first_vertex != last_vertex)
 			return 0;
 	}
-	int points = points_starting_value;
-	for (int e : path)
+	return points_history.empty() ? points_starting_value
+	                              : points_history.back();
+}
+
+bool Path::IsEulerian() const
+{
+	return (int)path.size() == graph.E();
+}
+
+bool Path::Replay(int first, const std::vector<int>& edges)
+{
+	if (!IsPath()) return false;
+	ResetPath();
+	if (!graph.HasVertexWithID(first) || !rule_loader.IsValid(graph))
+		return false;
+
+	std::unordered_map<int, const Edge*> edges_by_id;
+	for (const Edge* e : graph.edges)
+		edges_by_id[e->id] = e;
+	graph.Lock();
+	first_vertex = last_vertex = first;
+	VisitVertex(first);
+	for (int edge_id : edges)
 	{
-		const Edge& edge = graph.GetEdgeByIDConst(e);
-		if (color_operations.count(edge.Color())
-		 && color_operations.at(edge.Color()))
-			points = color_operations.at(edge.Color())(points);
-
-		if (color_operations.count(ANY_COLOR)
-		  && color_operations.at(ANY_COLOR))
-			points = color_operations.at(ANY_COLOR)(points);
+		if (edges_by_id.count(edge_id) == 0 || path_edges.count(edge_id)
+		 || !edges_by_id.at(edge_id)->HasEndpoint(last_vertex))
+		{
+			ResetPath();
+			return false;
+		}
+		const Edge& edge = *edges_by_id.at(edge_id);
+		AppendEdge(edge, edge.OtherEndpoint(last_vertex));
 	}
-	return points;
+	return true;
 }
 
 } // namespace graphcoloring
@@ -19,6 +19,9 @@
 #ifndef GRAPHCOLORING_LEVELS_PATHS_PATH_H_
 #define GRAPHCOLORING_LEVELS_PATHS_PATH_H_
 
+#include <unordered_set>
+#include <unordered_map>
+
 #include "gui/window.hpp"
 #include "graphcoloring/levels/rules/ruleloader.hpp"
 
@@ -33,12 +36,16 @@ public:
 	void LoadFromDocument(const pugi::xml_document& document);
 	void ResetPath();
 	bool IsPath() const; // Is there a path in the document?
-	std::vector<int> GetPath() const;
-	std::set<int> PathEdgeSet() const;
-	std::set<int> PathVertexSet() const;
+	const std::vector<int>& GetPath() const;
+	const std::unordered_set<int>& PathEdgeSet() const;
+	const std::unordered_set<int>& PathVertexSet() const;
 	int LastVertex() const; // -1 if no last vertex
 	bool IsMakingPath() const;
-	int Points() const;
+	int Points() const; // O(1)
+	bool IsEulerian() const; // Does the path use every edge in the graph?
+	// Replace the path with the given trail (e.g. from Eulerian::FindTrail).
+	// Returns false, and leaves no path, if it is not a trail in the graph.
+	bool Replay(int first_vertex, const std::vector<int>& edges);
 private:
 	enum class Type
 	{
@@ -50,6 +57,11 @@ private:
 	static constexpr gui::Color ANY_COLOR = 0;
 	void LoadFromNode(pugi::xml_node node);
 	void RightClick();
+	void AppendEdge(const Edge& edge, int vertex_id); // Extend the path to vertex_id
+	void PopEdge(); // Remove the last edge of the path
+	void VisitVertex(int vertex_id);
+	void LeaveVertex(int vertex_id);
+	int ApplyOperations(int points, gui::Color edge_color) const;
 	operation_t LoadOperation(pugi::xml_node node);
 	gui::Window* window;
 	Graph& graph;
@@ -60,6 +72,10 @@ private:
 	int first_vertex = -1;
 	int last_vertex = -1;
 	std::vector<int> path;
+	std::vector<int> points_history; // Points after each edge in the path.
+	std::unordered_set<int> path_edges;
+	std::unordered_set<int> path_vertices;
+	std::unordered_map<int, int> vertex_visits; // Number of times the path passes through each vertex.
 	int points_starting_value = 0;
 	std::map<gui::Color, operation_t> color_operations;
 
@@ -18,6 +18,8 @@
 
 #include "pointcalculator.hpp"
 
+#include "utils/profiler.hpp"
+
 namespace graphcoloring {
 
 PointCalculator::PointCalculator(const ValueLoader& value_loader_,
@@ -29,19 +31,23 @@ PointCalculator::PointCalculator(const ValueLoader& value_loader_,
 
 int PointCalculator::Points(const Graph& graph, bool check_if_invalid) const
 {
+	utils::profiler::ScopedTimer timer("PointCalculator::Points");
 	if (check_if_invalid)
 	{
 		bool is_valid = rule_loader.IsValid(graph);
 		if (!is_valid) return 0;
 	}
+	return GraphPoints(graph) + path.Points();
+}
+
+int PointCalculator::GraphPoints(const Graph& graph) const
+{
+	utils::profiler::ScopedTimer timer("PointCalculator::GraphPoints");
 	int points = value_loader.Points(graph);
 	for (const Vertex* v : graph.vertices)
 		points += color_loader.GetVertexPoints(v->Color());
 	for (const Edge* e : graph.edges)
 		points += color_loader.GetEdgePoints(e->Color());
-
-	points += path.Points();
-
 	return points;
 }
 
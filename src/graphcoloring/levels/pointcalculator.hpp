@@ -32,6 +32,7 @@ public:
 		const RuleLoader& rule_loader, const ColorLoader& color_loader,
 		const Path& path);
 	int Points(const Graph& graph, bool check_if_invalid = true) const;
+	int GraphPoints(const Graph& graph) const; // Not counting the path, or checking if it's invalid.
 	virtual ~PointCalculator() {}
 private:
 	const ValueLoader& value_loader;
@@ -18,7 +18,6 @@
 
 #include "boundrule.hpp"
 
-#include "graphcoloring/level.hpp"
 #include "utils/errors.hpp"
 
 namespace graphcoloring {
@@ -50,13 +49,14 @@ void BoundRule::LoadFromNode(pugi::xml_node node,
 	else
 		rule_type = EDGE_RULE;
 	color = ColorFromAttribute(node.attribute("color"), color_loader);
+	palette = color_loader.Colors();
 	bound = node.attribute(bound_type == MINIMUM ? "min" : "max").as_int(0);
 }
 
 bool BoundRule::CheckAllCounts(const Graph& graph) const
 {
 	std::map<gui::Color, int> counts;
-	for (gui::Color color : Level::colors)
+	for (gui::Color color : palette)
 		counts[color] = 0;
 	if (rule_type == VERTEX_RULE)
 	{
@@ -92,21 +92,42 @@ bool BoundRule::ObeysRule(const Graph& graph) const
 		return CheckAllCounts(graph);
 
 	int count = 0;
+	gui::Color same_color = ANY_COLOR;
 	if (rule_type == VERTEX_RULE)
 	{
 		for (const Vertex* v : graph.vertices)
-			if (IsSameColor(v->Color(), color))
+			if (IsSameColor(v->Color(), color, same_color))
 				count++;
 	}
 	else
 	{
 		for (const Edge* e : graph.edges)
-			if (IsSameColor(e->Color(), color))
+			if (IsSameColor(e->Color(), color, same_color))
 				count++;
 	}
 	return bound_type == MINIMUM ? (count >= bound) : (count <= bound);
 }
 
+bool BoundRule::IsVertexRule() const
+{
+	return rule_type == VERTEX_RULE;
+}
+
+bool BoundRule::IsMinimum() const
+{
+	return bound_type == MINIMUM;
+}
+
+gui::Color BoundRule::Color() const
+{
+	return color;
+}
+
+int BoundRule::Bound() const
+{
+	return bound;
+}
+
 int BoundRule::Render(gui::Window* window, int x, int y, int width) const
 {
 	int r = Vertex::VERTEX_RADIUS;
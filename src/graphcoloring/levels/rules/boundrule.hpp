@@ -36,6 +36,10 @@ public:
 	void LoadFromNode(pugi::xml_node node, const ColorLoader& color_loader);
 	virtual ~BoundRule() {}
 	bool ObeysRule(const Graph& graph) const;
+	bool IsVertexRule() const; // false for edge rules
+	bool IsMinimum() const; // false for maxima
+	gui::Color Color() const;
+	int Bound() const;
 	int Render(gui::Window* window, int x, int y, int width) const;
 private:
 	bool CheckAllCounts(const Graph& graph) const;
@@ -47,6 +51,7 @@ private:
 	int bound;
 	bool bound_type;
 	bool rule_type;
+	std::vector<gui::Color> palette; // The level's colors, for same-color rules
 };
 
 } // namespace rules
@@ -39,16 +39,18 @@ void EdgeRule::LoadFromNode(pugi::xml_node node,const ColorLoader& color_loader)
 
 bool EdgeRule::ObeysRule(const Edge& edge) const
 {
-	ResetSameColor();
-	if (!IsSameColor(edge.Color(), edge_color)) return true;
+	return ObeysRule(edge.from.Color(), edge.to.Color(), edge.Color());
+}
+
+bool EdgeRule::ObeysRule(gui::Color v1, gui::Color v2, gui::Color edge) const
+{
+	gui::Color same_color = ANY_COLOR;
+	if (!IsSameColor(edge, edge_color, same_color)) return true;
 
-	gui::Color v1 = edge.from.Color();
-	gui::Color v2 = edge.to.Color();
-	bool obeys
-		= !((IsSameColor(v1,vertex_color1) && IsSameColor(v2,vertex_color2))
-		 || (IsSameColor(v2,vertex_color1) && IsSameColor(v1,vertex_color2)));
-	ResetSameColor();
-	return obeys;
+	return !((IsSameColor(v1, vertex_color1, same_color)
+	       && IsSameColor(v2, vertex_color2, same_color))
+	      || (IsSameColor(v2, vertex_color1, same_color)
+	       && IsSameColor(v1, vertex_color2, same_color)));
 }
 
 bool EdgeRule::ObeysRule(const Graph& graph) const
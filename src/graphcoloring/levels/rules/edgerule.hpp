@@ -35,6 +35,7 @@ public:
 	EdgeRule(pugi::xml_node node, const ColorLoader& color_loader);
 	void LoadFromNode(pugi::xml_node node, const ColorLoader& color_loader);
 	bool ObeysRule(const Graph& graph) const;
+	bool ObeysRule(gui::Color v1, gui::Color v2, gui::Color edge) const; // For an edge with these colors
 	int Render(gui::Window* window, int x, int y, int width) const;
 	virtual ~EdgeRule() {}
 private:
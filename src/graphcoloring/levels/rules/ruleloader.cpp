@@ -19,6 +19,8 @@
 #include "ruleloader.hpp"
 
 #include "graphcoloring/graphcoloring.hpp"
+#include "graphcoloring/graphs/edgecoloring.hpp"
+#include "utils/profiler.hpp"
 
 namespace graphcoloring {
 
@@ -32,6 +34,8 @@ void RuleLoader::LoadDocument(const pugi::xml_document& document,
 		std::string name = rule_node.name();
 		if (name == "connected")
 			connected_rule = true;
+		if (name == "proper-edge-coloring")
+			proper_edge_coloring_rule = true;
 		// These node methods will check the name of the node.
 		LoadEdgeRule(rule_node, color_loader);
 		LoadMaximumRule(rule_node, color_loader);
@@ -64,14 +68,56 @@ void RuleLoader::LoadMaximumRule(pugi::xml_node node,
 
 bool RuleLoader::IsValid(const Graph& graph) const
 {
+	utils::profiler::ScopedTimer timer("RuleLoader::IsValid");
 	for (auto& rule : all_rules)
 		if (!rule->ObeysRule(graph))
 			return false;
 	if (connected_rule && !graph.IsConnected())
 		return false;
+	if (proper_edge_coloring_rule && !EdgeColoring::IsProper(graph))
+		return false;
 	return true;
 }
 
+int RuleLoader::Violations(const Graph& graph) const
+{
+	int violations = 0;
+	for (const rules::EdgeRule& rule : edge_rules)
+		for (const Edge* e : graph.edges)
+			if (!rule.ObeysRule(e->from.Color(), e->to.Color(), e->Color()))
+				violations++;
+	for (const rules::BoundRule& rule : maximum_rules)
+		if (!rule.ObeysRule(graph))
+			violations++;
+	if (connected_rule)
+		for (const Vertex* v : graph.vertices)
+			if (!graph.IsConnected(v->id))
+				violations++;
+	if (proper_edge_coloring_rule)
+		violations += EdgeColoring::Conflicts(graph);
+	return violations;
+}
+
+const std::vector<rules::EdgeRule>& RuleLoader::EdgeRules() const
+{
+	return edge_rules;
+}
+
+const std::vector<rules::BoundRule>& RuleLoader::BoundRules() const
+{
+	return maximum_rules;
+}
+
+bool RuleLoader::MustBeConnected() const
+{
+	return connected_rule;
+}
+
+bool RuleLoader::MustBeProperEdgeColoring() const
+{
+	return proper_edge_coloring_rule;
+}
+
 void RuleLoader::RenderRules(gui::Window* window) const
 {
 	window->SetDrawColor(GraphColoring::BACKGROUND_COLOR);
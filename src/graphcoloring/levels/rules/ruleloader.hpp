@@ -36,7 +36,12 @@ public:
 	void LoadDocument(const pugi::xml_document& document,
 		const ColorLoader& color_loader);
 	bool IsValid(const Graph& graph) const; // O(Rules * Edges)
+	int Violations(const Graph& graph) const; // 0 iff valid. Counts each edge breaking a rule, and each unconnected vertex.
 	void RenderRules(gui::Window* window) const;
+	const std::vector<rules::EdgeRule>& EdgeRules() const;
+	const std::vector<rules::BoundRule>& BoundRules() const;
+	bool MustBeConnected() const;
+	bool MustBeProperEdgeColoring() const;
 private:
 	void LoadEdgeRule(pugi::xml_node node, const ColorLoader& color_loader);
 	void LoadMaximumRule(pugi::xml_node node, const ColorLoader& color_loader);
@@ -44,6 +49,7 @@ private:
 	std::vector<rules::EdgeRule> edge_rules;
 	std::vector<rules::BoundRule> maximum_rules;
 	bool connected_rule = false; // true if the graph should be connected
+	bool proper_edge_coloring_rule = false; // true if adjacent edges should have different colors
 	std::vector<std::unique_ptr<rules::Rule>> all_rules;
 
 };
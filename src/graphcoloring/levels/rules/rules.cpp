@@ -21,11 +21,8 @@
 namespace graphcoloring {
 namespace rules {
 
-static gui::Color same_color = ANY_COLOR;
-
-void ResetSameColor() { same_color = ANY_COLOR; }
-
-bool IsSameColor(gui::Color color1, gui::Color color2)
+bool IsSameColor(gui::Color color1, gui::Color color2,
+	gui::Color& same_color)
 {
 	if (color1 == ANY_COLOR || color2 == ANY_COLOR)
 		return true;
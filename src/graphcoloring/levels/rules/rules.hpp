@@ -28,8 +28,9 @@ namespace rules {
 
 constexpr gui::Color ANY_COLOR = 0;
 constexpr gui::Color SAME_COLOR = 1; // Refers to patterns like same-red-same, which can mean blue-red-blue, red-red-red, etc.
-extern void ResetSameColor(); // Forget about "same" color
-extern bool IsSameColor(gui::Color color1, gui::Color color2);
+// same_color is what "same" has matched so far; start it at ANY_COLOR.
+extern bool IsSameColor(gui::Color color1, gui::Color color2,
+	gui::Color& same_color);
 extern gui::Color RenderColor(gui::Color color); // Turns ANY_COLOR into white.
 extern gui::Color ColorFromAttribute(pugi::xml_attribute attr,
 	const ColorLoader& color_loader); // ANY_COLOR if attribute is empty.
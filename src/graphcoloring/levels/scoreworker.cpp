@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "scoreworker.hpp"
+
+#include "utils/profiler.hpp"
+
+namespace graphcoloring {
+
+gboolean DeliverScore(gpointer data)
+{
+	ScoreWorker* worker = (ScoreWorker*) data;
+	worker->Deliver();
+	return G_SOURCE_REMOVE;
+}
+
+ScoreWorker::ScoreWorker(const ValueLoader& value_loader_,
+		const RuleLoader& rule_loader_,
+		const PointCalculator& point_calculator_,
+		std::function<void()> on_result_)
+	: value_loader(value_loader_), rule_loader(rule_loader_),
+	  point_calculator(point_calculator_), on_result(on_result_),
+	  window(800, 600),
+	  graph(context, &window, viewport_position),
+	  cache(CACHE_SIZE),
+	  thread(&ScoreWorker::Run, this)
+{}
+
+ScoreWorker::~ScoreWorker()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	submitted.notify_one();
+	thread.join();
+	if (deliver_source)
+		g_source_remove(deliver_source);
+}
+
+void ScoreWorker::Submit(std::shared_ptr<const Graph::Snapshot> snapshot)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (const Result* cached = cache.Find(snapshot->hash))
+		{
+			latest = *cached;
+			latest.revision = snapshot->revision;
+			pending = nullptr;
+			has_submitted = true;
+			last_submitted = snapshot->revision;
+			return;
+		}
+		if (has_submitted && snapshot->revision == last_submitted)
+			return;
+		has_submitted = true;
+		last_submitted = snapshot->revision;
+		pending = snapshot;
+	}
+	submitted.notify_one();
+}
+
+const ScoreWorker::Result& ScoreWorker::Latest() const
+{
+	return latest;
+}
+
+void ScoreWorker::Wait()
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		if (!has_submitted
+		 || (latest.done && latest.revision == last_submitted))
+			return; // Nothing to wait for, or it came from the cache.
+		scored.wait(lock, [this] () {
+			return finished.done && finished.revision == last_submitted;
+		});
+		// Deliver it here instead.
+		if (deliver_source)
+			g_source_remove(deliver_source);
+		deliver_source = 0;
+	}
+	Deliver();
+}
+
+bool ScoreWorker::IsSuperseded()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return pending || stopping;
+}
+
+void ScoreWorker::Run()
+{
+	while (true)
+	{
+		std::shared_ptr<const Graph::Snapshot> snapshot;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			submitted.wait(lock, [this] () { return pending || stopping; });
+			if (stopping) return;
+			snapshot.swap(pending);
+		}
+
+		// Each job, including ones which give up.
+		utils::profiler::ScopedTimer timer("ScoreWorker::Run");
+		Result result;
+		result.done = true;
+		result.revision = snapshot->revision;
+		uint64_t hash = snapshot->hash;
+		graph.Restore(*snapshot);
+		snapshot = nullptr;
+		if (IsSuperseded()) continue;
+		result.is_valid = rule_loader.IsValid(graph);
+		if (IsSuperseded()) continue;
+		result.points = point_calculator.GraphPoints(graph);
+		if (IsSuperseded()) continue;
+		result.objective = value_loader.ObjectivePoints(graph);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		cache.Insert(hash, result);
+		if (pending || stopping) continue;
+		finished = result;
+		if (!deliver_source)
+			deliver_source = g_idle_add(DeliverScore, this);
+		scored.notify_all();
+	}
+}
+
+void ScoreWorker::Deliver()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		// A newer result may have come from the cache in the meantime.
+		if (!latest.done || finished.revision > latest.revision)
+			latest = finished;
+		deliver_source = 0;
+	}
+	if (on_result)
+		on_result();
+}
+
+} // namespace graphcoloring
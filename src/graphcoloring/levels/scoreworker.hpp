@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_LEVELS_SCOREWORKER_H_
+#define GRAPHCOLORING_LEVELS_SCOREWORKER_H_
+
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <gtk/gtk.h>
+
+#include "gui/window.hpp"
+#include "utils/lrucache.hpp"
+#include "graphcoloring/graphs/graph.hpp"
+#include "valueloader.hpp"
+#include "rules/ruleloader.hpp"
+#include "pointcalculator.hpp"
+
+namespace graphcoloring {
+
+// Works out whether the player's graph is valid and how many points it's
+// worth on a worker thread, so big graphs don't hold up the GTK thread.
+// The GTK thread submits snapshots of the graph; results are posted back to
+// it with g_idle_add. Only the newest snapshot is kept: submitting one
+// replaces any job which hasn't started, and a job which is running gives up
+// as soon as a newer one arrives. Results are cached by the graph's hash, so
+// going back to a graph which has been scored recently (undoing a recoloring,
+// or loading a save) doesn't need the worker at all.
+// The loaders must not change while the worker exists.
+class ScoreWorker {
+public:
+	struct Result
+	{
+		bool done = false; // false until the first result comes in.
+		unsigned long revision = 0; // Revision of the graph which was scored
+		bool is_valid = false;
+		int points = 0; // See PointCalculator::GraphPoints
+		int objective = 0;
+	};
+	ScoreWorker(const ValueLoader& value_loader,
+		const RuleLoader& rule_loader,
+		const PointCalculator& point_calculator,
+		std::function<void()> on_result = nullptr); // on_result is called on the GTK thread.
+	virtual ~ScoreWorker(); // Waits for the current job to give up.
+	void Submit(std::shared_ptr<const Graph::Snapshot> snapshot); // Does nothing if it has already been submitted.
+	const Result& Latest() const; // Latest finished result
+	// Blocks until the last snapshot submitted has been scored, and delivers
+	// it without waiting for the main loop. For benchmarks.
+	void Wait();
+private:
+	static constexpr size_t CACHE_SIZE = 256;
+	friend gboolean DeliverScore(gpointer data);
+	void Run();
+	bool IsSuperseded(); // Has a newer snapshot been submitted?
+	void Deliver(); // Called on the GTK thread.
+	const ValueLoader& value_loader;
+	const RuleLoader& rule_loader;
+	const PointCalculator& point_calculator;
+	std::function<void()> on_result;
+	gui::Window window; // For graph's callbacks, which are never called.
+	gui::Viewport viewport_position;
+	LevelContext context; // graph's own, since it's on another thread
+	Graph graph; // Only used by the worker thread
+	Result latest;
+	std::mutex mutex; // Guards everything below
+	std::condition_variable submitted;
+	std::condition_variable scored; // Notified when finished is set
+	std::shared_ptr<const Graph::Snapshot> pending; // null if there's no job waiting
+	unsigned long last_submitted = 0;
+	bool has_submitted = false;
+	Result finished; // Waiting to be delivered
+	guint deliver_source = 0; // 0 if there's nothing to deliver
+	utils::LRUCache<uint64_t, Result> cache; // Keyed by Graph::Hash
+	bool stopping = false;
+	std::thread thread;
+};
+
+} // namespace graphcoloring
+
+#endif // GRAPHCOLORING_LEVELS_SCOREWORKER_H_
@@ -22,11 +22,11 @@
 #include <sstream>
 
 #include "utils/errors.hpp"
+#include "../graphs/edgecoloring.hpp"
+#include "../graphs/eulerian.hpp"
 
 namespace graphcoloring {
 
-std::map<std::string, Value::operation_t> Value::operation_table;
-
 Value::Value() : type(Type::NULL_TYPE) {}
 
 Value::Value(int val_)
@@ -127,33 +127,30 @@ Value::Value(pugi::xml_node node)
 	}
 }
 
-Value::operation_t Value::SimpleOperation(std::function<int(int,int)> op)
-{
-	return [op](const Graph&, int a, int b) { return op(a, b); };
-}
-
-Value::operation_t Value::SimpleBoolOperation(std::function<bool(int,int)> op)
+Value::simple_operation_t Value::SimpleBoolOperation(
+	std::function<bool(int,int)> op)
 {
-	return [op](const Graph&, int a, int b) { return op(a, b) ? 1 : 0; };
+	return [op](int a, int b) { return op(a, b) ? 1 : 0; };
 }
 
-Value::operation_t Value::SimpleLogicOperation(std::function<bool(bool,bool)>op)
+Value::simple_operation_t Value::SimpleLogicOperation(
+	std::function<bool(bool,bool)> op)
 {
-	return [op](const Graph&, int a, int b) {
+	return [op](int a, int b) {
 		return op(a != 0, b != 0) ? 1 : 0;
 	};
 }
 
-void Value::InitializeOperationTable()
+const Value::simple_operation_table_t& Value::SimpleOperationTable()
 {
-	operation_table = {
-			{"min", SimpleOperation([](int a, int b)->int{return std::min(a,b);})},
-			{"max", SimpleOperation([](int a, int b)->int{return std::max(a,b);})},
-			{"+", SimpleOperation(std::plus<int>())},
-			{"-", SimpleOperation(std::minus<int>())},
-			{"*", SimpleOperation(std::multiplies<int>())},
-			{"/", SimpleOperation(std::divides<int>())},
-			{"%", SimpleOperation(std::modulus<int>())},
+	static const simple_operation_table_t table = {
+			{"min", [](int a, int b)->int{return std::min(a,b);}},
+			{"max", [](int a, int b)->int{return std::max(a,b);}},
+			{"+", std::plus<int>()},
+			{"-", std::minus<int>()},
+			{"*", std::multiplies<int>()},
+			{"/", std::divides<int>()},
+			{"%", std::modulus<int>()},
 			{"=", SimpleBoolOperation(std::equal_to<int>())},
 			{"!=", SimpleBoolOperation(std::not_equal_to<int>())},
 			{"<", SimpleBoolOperation(std::less<int>())},
@@ -164,7 +161,15 @@ void Value::InitializeOperationTable()
 			{"or", SimpleLogicOperation(std::logical_or<bool>())},
 			{"not", SimpleLogicOperation([](bool a, bool b)->bool{
 				return  !a; // Ignore second argument.
-			})},
+			})}
+	};
+	return table;
+}
+
+const Value::operation_table_t& Value::OperationTable()
+{
+	static const operation_table_t table = [] () {
+		operation_table_t table = {
 			{"v1", [](const Graph& graph, int e, int)->int {
 				return graph.GetEdgeByIDConst(e).from.id;
 			}},
@@ -186,17 +191,42 @@ void Value::InitializeOperationTable()
 			{"edge-color", [](const Graph& graph, int e_id, int)->int {
 				const Edge& e = graph.GetEdgeByIDConst(e_id);
 				return (int)e.Color();
+			}},
+			{"has-eulerian-path", [](const Graph& graph, int, int)->int {
+				return Eulerian(graph).HasPath() ? 1 : 0;
+			}},
+			{"has-eulerian-cycle", [](const Graph& graph, int, int)->int {
+				return Eulerian(graph).HasCycle() ? 1 : 0;
+			}},
+			{"proper-edge-coloring", [](const Graph& graph, int, int)->int {
+				return EdgeColoring::IsProper(graph) ? 1 : 0;
+			}},
+			{"edge-color-conflicts", [](const Graph& graph, int, int)->int {
+				return EdgeColoring::Conflicts(graph);
+			}},
+			{"edge-coloring-colors", [](const Graph& graph, int, int)->int {
+				return EdgeColoring(graph).NumberOfColors();
 			}}
-	};
+		};
+		for (const auto& simple_operation : SimpleOperationTable())
+		{
+			simple_operation_t op = simple_operation.second;
+			table[simple_operation.first] =
+				[op](const Graph&, int a, int b) { return op(a, b); };
+		}
+		return table;
+	}();
+	return table;
 }
 
 void Value::ReadOperation(std::string op)
 {
-	if (operation_table.size() == 0)
-		InitializeOperationTable();
-	if (operation_table.count(op))
+	if (OperationTable().count(op))
 	{
-		operation = operation_table[op];
+		operation = OperationTable().at(op);
+		operation_name = op;
+		if (SimpleOperationTable().count(op))
+			simple_operation = SimpleOperationTable().at(op);
 	}
 	else
 	{
@@ -205,7 +235,7 @@ void Value::ReadOperation(std::string op)
 }
 
 std::vector<int> Value::EvalListOperation(const Graph& graph,
-	std::function<Value(std::string)> lookup_variable) const
+	lookup_t lookup_variable) const
 {
 	switch (type)
 	{
@@ -233,7 +263,7 @@ std::vector<int> Value::EvalListOperation(const Graph& graph,
 	case Type::LIST:
 	{
 		std::vector<int> out;
-		for (Value v : list)
+		for (const Value& v : list)
 			out.push_back(v.Eval(graph, lookup_variable));
 		return out;
 	}
@@ -262,8 +292,7 @@ std::vector<int> Value::EvalListOperation(const Graph& graph,
 	return std::vector<int>();
 }
 
-int Value::Eval(const Graph& graph,
-	std::function<Value(std::string)> lookup_variable) const
+int Value::Eval(const Graph& graph, lookup_t lookup_variable) const
 {
 	switch (type)
 	{
@@ -286,9 +315,9 @@ int Value::Eval(const Graph& graph,
 	{
 		assert(operation);
 		int x = fold_start->Eval(graph, lookup_variable);
-		for (const Value& v : val1->EvalListOperation(graph, lookup_variable))
+		for (int v : val1->EvalListOperation(graph, lookup_variable))
 		{
-			x = operation(graph, x, v.Eval(graph, lookup_variable));
+			x = operation(graph, x, v);
 		}
 		return x;
 	}
@@ -301,4 +330,106 @@ int Value::Eval(const Graph& graph,
 	return -1;
 }
 
+bool Value::IsConstant() const
+{
+	return type == Type::VALUE || type == Type::NULL_TYPE;
+}
+
+void Value::CountVariableReferences(std::map<std::string, int>& counts) const
+{
+	if (type == Type::VARIABLE)
+		counts[variable_name]++;
+	for (const std::shared_ptr<Value>& child : {fold_start, val1, val2})
+		if (child != nullptr)
+			child->CountVariableReferences(counts);
+	for (const Value& v : list)
+		v.CountVariableReferences(counts);
+}
+
+std::shared_ptr<Value> Value::OptimizedChild(
+	const std::shared_ptr<Value>& child, inline_t inline_variable) const
+{
+	if (child == nullptr)
+		return nullptr;
+	return std::make_shared<Value>(child->Optimized(inline_variable));
+}
+
+Value Value::Optimized(inline_t inline_variable) const
+{
+	if (type == Type::VARIABLE)
+	{
+		const Value* replacement = inline_variable(variable_name);
+		return replacement == nullptr ? *this : *replacement;
+	}
+
+	Value optimized = *this;
+	optimized.fold_start = OptimizedChild(fold_start, inline_variable);
+	optimized.val1 = OptimizedChild(val1, inline_variable);
+	optimized.val2 = OptimizedChild(val2, inline_variable);
+	for (Value& v : optimized.list)
+		v = v.Optimized(inline_variable);
+
+	if (type == Type::OPERATION && simple_operation
+	 && optimized.val1->IsConstant() && optimized.val2->IsConstant())
+	{
+		int a = optimized.val1->val, b = optimized.val2->val;
+		// Leave division by zero to be reported when it is evaluated.
+		if (b == 0 && (operation_name == "/" || operation_name == "%"))
+			return optimized;
+		return Value(simple_operation(a, b));
+	}
+	return optimized;
+}
+
+std::string Value::ToString() const
+{
+	std::stringstream s;
+	switch (type)
+	{
+	case Type::NULL_TYPE:
+		s << "_";
+		break;
+	case Type::VALUE:
+		s << val;
+		break;
+	case Type::VARIABLE:
+		s << variable_name;
+		break;
+	case Type::NUMBER_OF_VERTICES:
+		s << "V";
+		break;
+	case Type::NUMBER_OF_EDGES:
+		s << "E";
+		break;
+	case Type::VERTICES:
+		s << "vertices";
+		break;
+	case Type::EDGES:
+		s << "edges";
+		break;
+	case Type::LIST:
+		s << "[";
+		for (unsigned i = 0; i < list.size(); i++)
+			s << (i ? " " : "") << list[i].ToString();
+		s << "]";
+		break;
+	case Type::OPERATION:
+	case Type::ZIP:
+		s << "(" << (type == Type::ZIP ? "zip " : "") << operation_name
+		  << " " << val1->ToString() << " " << val2->ToString() << ")";
+		break;
+	case Type::MAP:
+		s << "(map " << operation_name << " " << val1->ToString() << ")";
+		break;
+	case Type::FOLD:
+		s << "(fold " << operation_name << " " << fold_start->ToString()
+		  << " " << val1->ToString() << ")";
+		break;
+	default:
+		s << "<" << (int)type << ">";
+		break;
+	}
+	return s.str();
+}
+
 } // namespace graphcoloring
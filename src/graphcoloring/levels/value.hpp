@@ -28,28 +28,44 @@ namespace graphcoloring {
 class Value {
 public:
 	typedef std::function<int(const Graph&,int,int)> operation_t;
+	typedef std::function<int(int,int)> simple_operation_t; // For operations which don't look at the graph.
+	typedef std::function<const Value&(const std::string&)> lookup_t;
+	// Returns the (optimized) value to substitute for a variable, or nullptr to keep the reference.
+	typedef std::function<const Value*(const std::string&)> inline_t;
 	Value();
 	Value(std::vector<Value> list);
 	Value(int val);
 	Value(const std::string& string);
 	Value(pugi::xml_node node);
 	virtual ~Value() {}
-	int Eval(const Graph& graph,
-		std::function<Value(std::string)> lookup_variable) const;
+	int Eval(const Graph& graph, lookup_t lookup_variable) const;
 	static void AddNodeToVariables(pugi::xml_node node);
+	bool IsConstant() const; // Does this value depend on neither the graph nor any variables?
+	void CountVariableReferences(std::map<std::string, int>& counts) const;
+	Value Optimized(inline_t inline_variable) const; // Constant folding and inlining
+	std::string ToString() const;
 private:
 	void FromString(const std::string& string);
 	void ReadOperation(std::string op);
-	static operation_t SimpleOperation(std::function<int(int,int)> op); // For operations which don't look at the graph.
 	// Bool operations return bools.
-	static operation_t SimpleBoolOperation(std::function<bool(int,int)> op);
+	static simple_operation_t SimpleBoolOperation(
+		std::function<bool(int,int)> op);
 	// Logical operations take bools and return bools.
-	static operation_t SimpleLogicOperation(std::function<bool(bool,bool)> op);
-	static void InitializeOperationTable();
+	static simple_operation_t SimpleLogicOperation(
+		std::function<bool(bool,bool)> op);
+	typedef std::map<std::string, operation_t> operation_table_t;
+	typedef std::map<std::string, simple_operation_t> simple_operation_table_t;
+	// Both tables are made the first time they're needed and never change,
+	// so they can be read from any thread.
+	static const simple_operation_table_t& SimpleOperationTable();
+	static const operation_table_t& OperationTable(); // Includes the simple operations
 	std::vector<int> EvalListOperation(const Graph& graph, // Handles anything that returns a list.
-		std::function<Value(std::string)> lookup_variable) const;
+		lookup_t lookup_variable) const;
+	std::shared_ptr<Value> OptimizedChild(const std::shared_ptr<Value>& child,
+		inline_t inline_variable) const;
 	operation_t operation;
-	static std::map<std::string, Value::operation_t> operation_table;
+	simple_operation_t simple_operation; // Empty if the operation looks at the graph.
+	std::string operation_name;
 	std::shared_ptr<Value> fold_start;
 	std::shared_ptr<Value> val1;
 	std::shared_ptr<Value> val2;
@@ -18,17 +18,22 @@
 
 #include "valueloader.hpp"
 
+#include <algorithm>
+
 #include "../level.hpp"
 #include "utils/errors.hpp"
+#include "utils/filesystem.hpp"
 
 namespace graphcoloring {
 
-ValueLoader::ValueLoader() : objective_points(-1) {}
+bool ValueLoader::dump_values = false;
+const std::vector<std::string> ValueLoader::ROOT_VARIABLES = {
+	"points", "objective"
+};
+std::map<std::string, ValueLoader::CachedModule> ValueLoader::include_cache;
+std::mutex ValueLoader::include_cache_mutex;
 
-void ValueLoader::AddNode(pugi::xml_node node)
-{
-	variables[node.attribute("id").value()] = Value(node);
-}
+ValueLoader::ValueLoader() : objective_points(-1) {}
 
 void ValueLoader::LoadGraph(const GraphLoader& graph_loader)
 {
@@ -47,35 +52,164 @@ void ValueLoader::LoadColors(const ColorLoader& color_loader)
 	}
 }
 
-void ValueLoader::LoadDocument(const pugi::xml_document& document)
+std::shared_ptr<const ValueLoader::module_t> ValueLoader::CompileValues(
+	pugi::xml_node values_node)
 {
-	for (pugi::xml_node node : document.child("values").children())
+	auto module = std::make_shared<module_t>();
+	for (pugi::xml_node node : values_node.children())
 	{
 		std::string name = node.name();
 		if (name == "comment") continue;
+		Definition definition;
 		if (name == "include")
 		{
-			pugi::xml_document doc;
 			std::string filename = node.attribute("file").value();
-			std::string path = "assets/levels/" + filename + ".xml";
-			doc.load_file(path.c_str());
-			LoadDocument(doc);
+			definition.include_path = "assets/levels/" + filename + ".xml";
 		}
 		else
 		{
-			AddNode(node);
+			definition.id = node.attribute("id").value();
+			definition.value = Value(node);
+		}
+		module->push_back(definition);
+	}
+	return module;
+}
+
+std::shared_ptr<const ValueLoader::module_t> ValueLoader::LoadInclude(
+	const std::string& path)
+{
+	std::lock_guard<std::mutex> lock(include_cache_mutex);
+	time_t modification_time = utils::filesystem::modification_time(path);
+	if (include_cache.count(path)
+	 && include_cache.at(path).modification_time == modification_time)
+		return include_cache.at(path).module;
+
+	pugi::xml_document document;
+	if (!document.load_file(path.c_str()))
+		utils::errors::Die("Failed to load include: " + path);
+	CachedModule cached;
+	cached.modification_time = modification_time;
+	cached.module = CompileValues(document.child("values"));
+	include_cache[path] = cached;
+	return cached.module;
+}
+
+void ValueLoader::AddModule(const module_t& module,
+	std::vector<std::string>& include_stack, std::set<std::string>& included)
+{
+	for (const Definition& definition : module)
+	{
+		if (definition.include_path.empty())
+		{
+			variables[definition.id] = definition.value;
+			continue;
 		}
+		const std::string& path = definition.include_path;
+		if (std::find(include_stack.begin(), include_stack.end(), path)
+			!= include_stack.end())
+		{
+			std::string cycle;
+			for (const std::string& p : include_stack)
+				cycle += p + " -> ";
+			utils::errors::Die("Include cycle: " + cycle + path);
+		}
+		if (included.count(path)) continue; // Already included by this level.
+		included.insert(path);
+		include_stack.push_back(path);
+		AddModule(*LoadInclude(path), include_stack, included);
+		include_stack.pop_back();
+	}
+}
+
+void ValueLoader::LoadDocument(const pugi::xml_document& document)
+{
+	std::vector<std::string> include_stack;
+	std::set<std::string> included;
+	AddModule(*CompileValues(document.child("values")), include_stack,
+		included);
+	Optimize();
+}
+
+std::set<std::string> ValueLoader::ReachableVariables(
+	const std::map<std::string, Value>& vars) const
+{
+	std::set<std::string> reachable;
+	std::vector<std::string> to_visit(ROOT_VARIABLES);
+	while (!to_visit.empty())
+	{
+		std::string name = to_visit.back();
+		to_visit.pop_back();
+		if (reachable.count(name) || vars.count(name) == 0)
+			continue;
+		reachable.insert(name);
+		std::map<std::string, int> references;
+		vars.at(name).CountVariableReferences(references);
+		for (const std::pair<const std::string, int>& reference : references)
+			to_visit.push_back(reference.first);
+	}
+	return reachable;
+}
+
+const Value* ValueLoader::OptimizeVariable(const std::string& name,
+	const std::map<std::string, int>& reference_counts,
+	std::map<std::string, Value>& optimized,
+	std::set<std::string>& in_progress) const
+{
+	if (variables.count(name) == 0 || in_progress.count(name))
+		return nullptr; // Undefined, or defined in terms of itself.
+	if (optimized.count(name) == 0)
+	{
+		in_progress.insert(name);
+		optimized[name] = variables.at(name).Optimized(
+			[&] (const std::string& reference)->const Value* {
+				return OptimizeVariable(reference, reference_counts,
+					optimized, in_progress);
+			});
+		in_progress.erase(name);
 	}
+	const Value& value = optimized.at(name);
+	bool is_root = std::find(ROOT_VARIABLES.begin(), ROOT_VARIABLES.end(),
+		name) != ROOT_VARIABLES.end();
+	bool is_single_use = reference_counts.count(name)
+		&& reference_counts.at(name) == 1;
+	if (value.IsConstant() || (is_single_use && !is_root))
+		return &value;
+	return nullptr;
+}
+
+void ValueLoader::Optimize()
+{
+	std::map<std::string, int> reference_counts;
+	for (const std::string& name : ReachableVariables(variables))
+		variables.at(name).CountVariableReferences(reference_counts);
+
+	std::map<std::string, Value> optimized;
+	std::set<std::string> in_progress;
+	for (const std::string& name : ROOT_VARIABLES)
+		OptimizeVariable(name, reference_counts, optimized, in_progress);
+
+	// Whatever was inlined is no longer referenced, so only keep what the
+	// optimized roots still reach.
+	variables.clear();
+	for (const std::string& name : ReachableVariables(optimized))
+		variables[name] = optimized.at(name);
 }
 
+void ValueLoader::Dump(std::ostream& os) const
+{
+	for (const std::pair<const std::string, Value>& variable : variables)
+		os << "\t" << variable.first << " = " << variable.second.ToString()
+		   << std::endl;
+}
 
 int ValueLoader::VariableValue(const Graph& graph,
 	const std::string& name) const
 {
 	if (variables.count(name) == 0)
 		utils::errors::Die("Variable not found: " + name);
-	std::function<Value(std::string)> lookup_variable
-		= [this] (std::string name)->Value {
+	Value::lookup_t lookup_variable
+		= [this] (const std::string& name)->const Value& {
 			if (variables.count(name) == 0)
 				utils::errors::Die("Variable not found: " + name);
 			return variables.at(name);
@@ -19,6 +19,12 @@
 #ifndef GRAPHCOLORING_LEVELS_VALUELOADER_H_
 #define GRAPHCOLORING_LEVELS_VALUELOADER_H_
 
+#include <set>
+#include <ostream>
+#include <memory>
+#include <mutex>
+#include <ctime>
+
 #include "value.hpp"
 
 #include "graphloader.hpp"
@@ -35,8 +41,39 @@ public:
 	int VariableValue(const Graph& graph, const std::string& name) const;
 	int Points(const Graph& graph) const;
 	int ObjectivePoints(const Graph& graph) const;
+	void Dump(std::ostream& os) const; // Print the variables the engine evaluates.
+	static bool dump_values; // Dump the optimized values of each level when it is loaded.
 private:
-	void AddNode(pugi::xml_node node);
+	// A compiled <values> node. Each definition is either an include or a variable.
+	struct Definition
+	{
+		std::string include_path; // Empty if this defines a variable
+		std::string id;
+		Value value;
+	};
+	typedef std::vector<Definition> module_t;
+	struct CachedModule
+	{
+		time_t modification_time;
+		std::shared_ptr<const module_t> module;
+	};
+	static std::shared_ptr<const module_t> CompileValues(
+		pugi::xml_node values_node);
+	static std::shared_ptr<const module_t> LoadInclude(const std::string& path);
+	void AddModule(const module_t& module,
+		std::vector<std::string>& include_stack,
+		std::set<std::string>& included);
+	// Folds constants, inlines single-use variables and drops unreachable ones.
+	void Optimize();
+	std::set<std::string> ReachableVariables(
+		const std::map<std::string, Value>& vars) const;
+	const Value* OptimizeVariable(const std::string& name,
+		const std::map<std::string, int>& reference_counts,
+		std::map<std::string, Value>& optimized,
+		std::set<std::string>& in_progress) const;
+	static const std::vector<std::string> ROOT_VARIABLES;
+	static std::map<std::string, CachedModule> include_cache; // Shared by all levels, keyed by path
+	static std::mutex include_cache_mutex;
 	std::map<std::string, Value> variables;
 	int objective_points;
 };
@@ -27,7 +27,8 @@ const char* const LevelSelect::LEVEL_LISTING_PATH = "saves/level-list.xml";
 
 LevelSelect::LevelSelect(gui::Window* window_,
 	level_click_callback_t level_click_callback_)
-	: window(window_), level_click_callback(level_click_callback_)
+	: window(window_), level_click_callback(level_click_callback_),
+	  grid_layer(window, [this](gui::Window*){RenderGrid();})
 {
 	ReadCategories();
 	window->SetRenderCallback([this](gui::Window*){Render();});
@@ -54,6 +55,7 @@ void LevelSelect::Scroll(int direction)
 	scroll_position.y -= direction * 10;
 	if (scroll_position.y > 0)
 		scroll_position.y = 0;
+	grid_layer.Invalidate();
 }
 
 pugi::xml_object_range<pugi::xml_named_node_iterator>
@@ -132,18 +134,24 @@ void LevelSelect::Render()
 
 	window->SetDrawColor(GraphColoring::BACKGROUND_COLOR);
 	window->Clear();
+	grid_layer.Render();
 
-	// Draw Buttons
+	// Draw hover highlights over the grid
 	for (std::unique_ptr<gui::Button>& button : buttons)
-		button->Render();
+		if (button->IsHovering())
+			button->Render();
+}
+
+void LevelSelect::RenderGrid()
+{
+	for (std::unique_ptr<gui::Button>& button : buttons)
+		button->RenderStatic();
 
 	RenderCategoryLabels();
 	window->SetDrawColor(0xDDDDDDFF);
 	window->DrawText(std::string("Points: ") + std::to_string(total_points),
 		gui::Position(window->GetWidth()-10, 10),
 		gui::Alignment::RIGHT, gui::Alignment::TOP);
-
-
 }
 
 void LevelSelect::RenderCategoryLabels()
@@ -42,6 +42,7 @@ private:
 	void MakeLevelButtons();
 	void Render();
 	void RenderCategoryLabels();
+	void RenderGrid(); // Everything which doesn't change on hover
 	static constexpr double LEVEL_CIRCLE_RADIUS = 0.06; // As a percentage of min(width, height)
 	static constexpr double LEVEL_CIRCLE_PADDING = 0.03;
 	static constexpr double TEXT_SIZE = 0.06;
@@ -56,6 +57,7 @@ private:
 	gui::Size min_dimension_both; // min_dimension_both.x,y = min(window width, window height)
 	gui::Size min_dimension_y; // min_dimension_y.x = window width, .y = min(window width, window height)
 	gui::Position scroll_position;
+	gui::Layer grid_layer;
 	int lowest_y; // Lowest y position of bottom of level circle. Used for calculating maximum scroll down.
 };
 
@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "renderbenchmark.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+#include "level.hpp"
+#include "solvers/leveloptimizer.hpp"
+#include "gui/offscreenwindow.hpp"
+#include "utils/errors.hpp"
+#include "utils/filesystem.hpp"
+
+namespace graphcoloring {
+
+namespace {
+
+// The same size as the game's window
+constexpr int WIDTH = 800, HEIGHT = 600;
+
+} // namespace
+
+int RunRenderBenchmark(std::vector<std::string> levels, int frames,
+	const std::string& png_directory)
+{
+	if (levels.empty()) levels = solvers::ListLevels();
+	if (frames < 1) frames = 1;
+	if (!png_directory.empty())
+		utils::filesystem::create_directory(png_directory);
+
+	int status = 0;
+	std::cout << "Milliseconds per frame at " << WIDTH << "x" << HEIGHT
+		<< " over " << frames << " frames" << std::endl;
+	std::cout << std::left << std::setw(40) << "level" << std::right
+		<< std::setw(9) << "first" << std::setw(9) << "min"
+		<< std::setw(9) << "avg" << std::setw(9) << "max"
+		<< std::setw(9) << "drawn" << std::setw(9) << "strokes" << std::endl;
+	for (const std::string& name : levels)
+	{
+		size_t slash = name.find('/');
+		if (slash == std::string::npos)
+			utils::errors::Die("Levels should be given as category/level.");
+		std::string category_id = name.substr(0, slash);
+		std::string level_id = name.substr(slash + 1);
+
+		gui::OffscreenWindow window(WIDTH, HEIGHT);
+		Level level(&window, category_id, level_id, false);
+		// So that every frame (and every run) shows the score.
+		level.WaitForScore();
+
+		// The first frame also lays out text and draws the layers.
+		double first = window.RenderFrame();
+		double min = first, max = 0, total = 0;
+		for (int frame = 0; frame < frames; frame++)
+		{
+			double seconds = window.RenderFrame();
+			if (frame == 0 || seconds < min) min = seconds;
+			max = std::max(max, seconds);
+			total += seconds;
+		}
+		const gui::Window::FrameStats& stats = window.LastFrameStats();
+		std::cout << std::left << std::setw(40) << name << std::right
+			<< std::fixed << std::setprecision(3)
+			<< std::setw(9) << 1000 * first << std::setw(9) << 1000 * min
+			<< std::setw(9) << 1000 * total / frames
+			<< std::setw(9) << 1000 * max << std::setw(9) << stats.drawn
+			<< std::setw(9) << stats.strokes << std::endl;
+
+		if (!png_directory.empty())
+		{
+			std::string filename =
+				png_directory + "/" + category_id + "-" + level_id + ".png";
+			if (!window.WritePNG(filename))
+			{
+				std::cerr << "Could not write " << filename << std::endl;
+				status = 1;
+			}
+		}
+	}
+	return status;
+}
+
+} // namespace graphcoloring
@@ -0,0 +1,38 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_RENDERBENCHMARK_H_
+#define GRAPHCOLORING_RENDERBENCHMARK_H_
+
+#include <string>
+#include <vector>
+
+namespace graphcoloring {
+
+// Draws each level (given as category/level, or every level in the level list
+// if there are none) on a gui::OffscreenWindow the size of the game's window,
+// and prints a table of frame times and FrameStats to stdout. No display is
+// needed, and saved progress is loaded but never written. If png_directory
+// isn't empty, the last frame of each level is saved there as
+// category-level.png. Returns the exit status for main.
+extern int RunRenderBenchmark(std::vector<std::string> levels, int frames = 100,
+	const std::string& png_directory = "");
+
+} // namespace graphcoloring
+
+#endif // GRAPHCOLORING_RENDERBENCHMARK_H_
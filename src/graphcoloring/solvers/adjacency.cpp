@@ -0,0 +1,190 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "adjacency.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+#include "utils/errors.hpp"
+
+namespace graphcoloring {
+namespace solvers {
+
+Adjacency::Adjacency(const Graph& graph)
+	: Adjacency(graph.V(), {})
+{
+	vertex_ids.clear();
+	indices.clear();
+	for (const Vertex* v : graph.vertices)
+	{
+		indices[v->id] = vertex_ids.size();
+		vertex_ids.push_back(v->id);
+	}
+	for (const Edge* e : graph.edges)
+		AddEdge(indices.at(e->from.id), indices.at(e->to.id));
+	SortNeighbors();
+}
+
+Adjacency::Adjacency(int n, const std::vector<std::pair<int,int>>& edges)
+	: n(n), words((n + WORD_BITS - 1) / WORD_BITS),
+	  bits(n <= MAX_ROWS_SIZE ? (size_t)n * words : 0, 0), neighbors(n),
+	  vertex_ids(n)
+{
+	for (int v = 0; v < n; v++)
+	{
+		vertex_ids[v] = v;
+		indices[v] = v;
+	}
+	for (const std::pair<int,int>& edge : edges)
+	{
+		if (edge.first < 0 || edge.first >= n
+		 || edge.second < 0 || edge.second >= n)
+			utils::errors::Die("Edge endpoint out of range.");
+		AddEdge(edge.first, edge.second);
+	}
+	SortNeighbors();
+}
+
+Adjacency Adjacency::FromDIMACS(std::istream& in, std::string name)
+{
+	int n = -1;
+	std::vector<std::pair<int,int>> edges;
+	std::string line;
+	for (int line_number = 1; std::getline(in, line); line_number++)
+	{
+		std::istringstream stream(line);
+		std::string type;
+		if (!(stream >> type) || type == "c")
+			continue;
+		bool ok;
+		if (type == "p")
+		{
+			std::string format;
+			int m;
+			ok = (bool)(stream >> format >> n >> m) && n >= 0;
+		}
+		else if (type == "e")
+		{
+			int u, v;
+			ok = (bool)(stream >> u >> v) && n >= 0
+				&& u >= 1 && u <= n && v >= 1 && v <= n;
+			if (ok) edges.push_back(std::make_pair(u-1, v-1));
+		}
+		else
+		{
+			continue; // Ignore other lines (e.g. "n" or "x" lines)
+		}
+		if (!ok)
+			utils::errors::Die("Invalid DIMACS line in " + name + ":"
+				+ std::to_string(line_number) + ": " + line);
+	}
+	if (n < 0)
+		utils::errors::Die("No problem line in DIMACS file " + name + ".");
+	return Adjacency(n, edges);
+}
+
+void Adjacency::AddEdge(int u, int v)
+{
+	if (u == v)
+		return;
+	if (HasRows())
+	{
+		if (Adjacent(u, v))
+			return;
+		bits[(size_t)u * words + v / WORD_BITS] |= (word_t)1 << (v % WORD_BITS);
+		bits[(size_t)v * words + u / WORD_BITS] |= (word_t)1 << (u % WORD_BITS);
+		edge_count++;
+	}
+	// Without rows, repeated edges are removed by SortNeighbors.
+	neighbors[u].push_back(v);
+	neighbors[v].push_back(u);
+}
+
+void Adjacency::SortNeighbors()
+{
+	if (HasRows())
+		return; // Already unique; keep the order the edges were added in.
+	edge_count = 0;
+	for (std::vector<int>& list : neighbors)
+	{
+		std::sort(list.begin(), list.end());
+		list.erase(std::unique(list.begin(), list.end()), list.end());
+		edge_count += list.size();
+	}
+	edge_count /= 2;
+}
+
+int Adjacency::Size() const
+{
+	return n;
+}
+
+int Adjacency::EdgeCount() const
+{
+	return edge_count;
+}
+
+bool Adjacency::HasRows() const
+{
+	return n <= MAX_ROWS_SIZE;
+}
+
+int Adjacency::Words() const
+{
+	return words;
+}
+
+bool Adjacency::Adjacent(int u, int v) const
+{
+	if (!HasRows())
+		return std::binary_search(neighbors[u].begin(), neighbors[u].end(), v);
+	return (Row(u)[v / WORD_BITS] >> (v % WORD_BITS)) & 1;
+}
+
+const Adjacency::word_t* Adjacency::Row(int v) const
+{
+	if (!HasRows())
+		utils::errors::Die("Adjacency rows are only kept for up to "
+			+ std::to_string(MAX_ROWS_SIZE) + " vertices.");
+	return &bits[(size_t)v * words];
+}
+
+const std::vector<int>& Adjacency::Neighbors(int v) const
+{
+	return neighbors[v];
+}
+
+int Adjacency::Degree(int v) const
+{
+	return neighbors[v].size();
+}
+
+int Adjacency::VertexID(int v) const
+{
+	return vertex_ids[v];
+}
+
+int Adjacency::Index(int vertex_id) const
+{
+	auto it = indices.find(vertex_id);
+	return it == indices.end() ? -1 : it->second;
+}
+
+} // namespace solvers
+} // namespace graphcoloring
@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_SOLVERS_ADJACENCY_H_
+#define GRAPHCOLORING_SOLVERS_ADJACENCY_H_
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../graphs/graph.hpp"
+
+namespace graphcoloring {
+namespace solvers {
+
+// Compact, immutable adjacency structure for the solvers. Vertices are
+// renumbered 0..n-1; each one gets a neighbor list (for fast iteration) and,
+// unless there are more than MAX_ROWS_SIZE vertices, a bitset row (for fast
+// intersections). Edges are treated as undirected, and loops and repeated
+// edges are ignored.
+class Adjacency {
+public:
+	typedef uint64_t word_t;
+	static constexpr int WORD_BITS = 64;
+	// The rows take n^2/8 bytes: 32MB at this size, and 1.25GB at 100000.
+	static constexpr int MAX_ROWS_SIZE = 1 << 14;
+	Adjacency(const Graph& graph);
+	Adjacency(int n, const std::vector<std::pair<int,int>>& edges);
+	static Adjacency FromDIMACS(std::istream& in, std::string name = "input"); // DIMACS .col format
+	virtual ~Adjacency() {}
+	int Size() const; // Number of vertices
+	int EdgeCount() const;
+	bool HasRows() const;
+	int Words() const; // Number of words in each row
+	bool Adjacent(int u, int v) const; // O(1) with rows, O(log degree) without
+	const word_t* Row(int v) const; // Only if HasRows()
+	const std::vector<int>& Neighbors(int v) const; // Sorted, without rows
+	int Degree(int v) const;
+	int VertexID(int v) const; // ID of the Graph vertex with index v (v if not from a Graph)
+	int Index(int vertex_id) const; // Inverse of VertexID; -1 if there is no such vertex.
+private:
+	void AddEdge(int u, int v);
+	void SortNeighbors(); // Also removes repeated edges, without rows
+	int n;
+	int words;
+	int edge_count = 0;
+	std::vector<word_t> bits;
+	std::vector<std::vector<int>> neighbors;
+	std::vector<int> vertex_ids;
+	std::unordered_map<int, int> indices; // Vertex ID => index
+};
+
+} // namespace solvers
+} // namespace graphcoloring
+
+#endif // GRAPHCOLORING_SOLVERS_ADJACENCY_H_
@@ -0,0 +1,569 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#include "adjacency.hpp"
+#include "chromatic.hpp"
+#include "greedy.hpp"
+#include "leveloptimizer.hpp"
+#include "parallelchromatic.hpp"
+#include "rulesolver.hpp"
+#include "tabucol.hpp"
+#include "graphcoloring/levels/graphloader.hpp"
+#include "utils/errors.hpp"
+
+namespace graphcoloring {
+namespace solvers {
+
+namespace {
+
+constexpr double TABU_SECONDS = 1; // Budget for TabuCol in the coloring benchmark
+
+struct Instance
+{
+	std::string name;
+	Adjacency adjacency;
+	int chromatic_number; // -1 if unknown
+};
+
+typedef std::vector<std::pair<int,int>> edge_list_t;
+
+Adjacency Mycielski(int k) // myciel<k> in the DIMACS suite; chromatic number k+1
+{
+	int n = 2;
+	edge_list_t edges = {{0, 1}};
+	for (int i = 2; i < k+1; i++)
+	{
+		// Add a copy u_v of each vertex v adjacent to v's neighbors, and a
+		// vertex adjacent to all the copies.
+		edge_list_t new_edges = edges;
+		for (const std::pair<int,int>& edge : edges)
+		{
+			new_edges.push_back(std::make_pair(edge.first, n + edge.second));
+			new_edges.push_back(std::make_pair(n + edge.first, edge.second));
+		}
+		for (int v = 0; v < n; v++)
+			new_edges.push_back(std::make_pair(n + v, 2*n));
+		edges = new_edges;
+		n = 2*n + 1;
+	}
+	return Adjacency(n, edges);
+}
+
+Adjacency Queen(int size) // Queens on a size x size board, adjacent if they attack each other.
+{
+	edge_list_t edges;
+	for (int a = 0; a < size*size; a++)
+	{
+		for (int b = a+1; b < size*size; b++)
+		{
+			int ax = a % size, ay = a / size, bx = b % size, by = b / size;
+			if (ax == bx || ay == by || ax - ay == bx - by || ax + ay == bx + by)
+				edges.push_back(std::make_pair(a, b));
+		}
+	}
+	return Adjacency(size*size, edges);
+}
+
+Adjacency Random(int n, double p, unsigned seed) // Erdos-Renyi G(n, p)
+{
+	std::mt19937 rng(seed);
+	std::bernoulli_distribution has_edge(p);
+	edge_list_t edges;
+	for (int u = 0; u < n; u++)
+		for (int v = u+1; v < n; v++)
+			if (has_edge(rng))
+				edges.push_back(std::make_pair(u, v));
+	return Adjacency(n, edges);
+}
+
+// n random points in the unit square, adjacent if they are closer than radius.
+Adjacency RandomGeometric(int n, double radius, unsigned seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> coordinate(0, 1);
+	std::vector<std::pair<double,double>> points(n);
+	for (std::pair<double,double>& point : points)
+	{
+		point.first = coordinate(rng);
+		point.second = coordinate(rng);
+	}
+	edge_list_t edges;
+	for (int u = 0; u < n; u++)
+		for (int v = u+1; v < n; v++)
+			if (std::hypot(points[u].first - points[v].first,
+				points[u].second - points[v].second) < radius)
+				edges.push_back(std::make_pair(u, v));
+	return Adjacency(n, edges);
+}
+
+// The starting graph of a level
+Adjacency LevelGraph(gui::Window* window, const std::string& category_id,
+	const std::string& level_id)
+{
+	pugi::xml_document document;
+	std::string filename = LevelOptimizer::LevelFile(category_id, level_id);
+	if (!document.load_file(filename.c_str()))
+		utils::errors::Die("Could not load level " + filename);
+	LevelContext context;
+	ColorLoader color_loader(context);
+	color_loader.LoadDocument(document);
+	GlobalLoader global_loader;
+	global_loader.LoadDocument(document);
+	gui::Viewport viewport_position;
+	Graph graph(context, window, viewport_position);
+	GraphLoader(color_loader, global_loader).LoadDocument(document, graph);
+	return Adjacency(graph);
+}
+
+std::vector<Instance> BuiltinInstances()
+{
+	return {
+		{"myciel3", Mycielski(3), 4},
+		{"myciel4", Mycielski(4), 5},
+		{"myciel5", Mycielski(5), 6},
+		{"queen5_5", Queen(5), 5},
+		{"queen6_6", Queen(6), 7},
+		{"queen7_7", Queen(7), 7},
+		{"queen8_8", Queen(8), 9},
+		{"random-50-0.3", Random(50, 0.3, 1), -1},
+		{"random-70-0.5", Random(70, 0.5, 2), -1},
+		{"random-100-0.1", Random(100, 0.1, 3), -1},
+	};
+}
+
+std::vector<Instance> GreedyInstances()
+{
+	std::vector<Instance> instances = {
+		{"random-100-0.1", Random(100, 0.1, 3), -1},
+		{"random-500-0.5", Random(500, 0.5, 4), -1},
+		{"random-2000-0.01", Random(2000, 0.01, 5), -1},
+		{"geometric-500-0.1", RandomGeometric(500, 0.1, 6), -1},
+		{"geometric-2000-0.05", RandomGeometric(2000, 0.05, 7), -1},
+		{"queen8_8", Queen(8), 9},
+		{"myciel5", Mycielski(5), 6},
+	};
+	gui::Window window(800, 600);
+	for (const std::string& level : ListLevels())
+	{
+		size_t slash = level.find('/');
+		Adjacency adjacency = LevelGraph(&window, level.substr(0, slash),
+			level.substr(slash + 1));
+		if (adjacency.EdgeCount() > 0)
+			instances.push_back({level, adjacency, -1});
+	}
+	return instances;
+}
+
+// Average seconds per call of heuristic, repeating it for at least 10ms.
+double TimeHeuristic(const Heuristic& heuristic, const Adjacency& adjacency)
+{
+	typedef std::chrono::steady_clock clock;
+	clock::time_point start = clock::now();
+	double seconds;
+	int runs = 0;
+	do
+	{
+		heuristic.color(adjacency);
+		runs++;
+		seconds = std::chrono::duration<double>(clock::now() - start).count();
+	}
+	while (seconds < 0.01);
+	return seconds / runs;
+}
+
+Adjacency Grid(int width, int height)
+{
+	edge_list_t edges;
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			if (x+1 < width)
+				edges.push_back(std::make_pair(y*width + x, y*width + x+1));
+			if (y+1 < height)
+				edges.push_back(std::make_pair(y*width + x, (y+1)*width + x));
+		}
+	}
+	return Adjacency(width*height, edges);
+}
+
+Adjacency Cycle(int n)
+{
+	edge_list_t edges;
+	for (int v = 0; v < n; v++)
+		edges.push_back(std::make_pair(v, (v+1) % n));
+	return Adjacency(n, edges);
+}
+
+Adjacency Petersen() // Chromatic index 4
+{
+	edge_list_t edges;
+	for (int i = 0; i < 5; i++)
+	{
+		edges.push_back(std::make_pair(i, (i+1) % 5)); // Outer cycle
+		edges.push_back(std::make_pair(i, i+5));
+		edges.push_back(std::make_pair(i+5, (i+2) % 5 + 5)); // Inner star
+	}
+	return Adjacency(10, edges);
+}
+
+// G(n, p) restricted to edges between different classes of a random
+// partition into k classes, so that it has a k-coloring.
+Adjacency Planted(int n, int k, double p, unsigned seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> class_of(0, k-1);
+	std::bernoulli_distribution has_edge(p);
+	std::vector<int> classes(n);
+	for (int& c : classes)
+		c = class_of(rng);
+	edge_list_t edges;
+	for (int u = 0; u < n; u++)
+		for (int v = u+1; v < n; v++)
+			if (classes[u] != classes[v] && has_edge(rng))
+				edges.push_back(std::make_pair(u, v));
+	return Adjacency(n, edges);
+}
+
+struct RuleInstance
+{
+	std::string name;
+	Adjacency adjacency;
+	int colors;
+	std::string rules; // Children of the <rules> node
+	int is_solvable; // 1 or 0; -1 if unknown
+};
+
+constexpr const char* PROPER = "<edge-rule v1=\"same\" v2=\"same\"/>";
+constexpr const char* PROPER_EDGES = "<proper-edge-coloring/>";
+
+std::vector<RuleInstance> BuiltinRuleInstances()
+{
+	std::string at_most_50 = "<vertex-maximum color=\"same\" max=\"50\"/>";
+	std::string at_most_49 = "<vertex-maximum color=\"same\" max=\"49\"/>";
+	return {
+		{"cycle-101 (2 colors)", Cycle(101), 2, PROPER, 0},
+		{"myciel4 (4 colors)", Mycielski(4), 4, PROPER, 0},
+		{"myciel4 (5 colors)", Mycielski(4), 5, PROPER, 1},
+		{"queen5_5 (5 colors)", Queen(5), 5, PROPER, 1},
+		{"queen6_6 (6 colors)", Queen(6), 6, PROPER, 0},
+		{"petersen edges (3 colors)", Petersen(), 3, PROPER_EDGES, 0},
+		{"petersen edges (4 colors)", Petersen(), 4, PROPER_EDGES, 1},
+		{"grid-10x10 max 50 (2 colors)", Grid(10, 10), 2, PROPER + at_most_50, 1},
+		{"grid-10x10 max 49 (2 colors)", Grid(10, 10), 2, PROPER + at_most_49, 0},
+		{"grid-30x30 (3 colors)", Grid(30, 30), 3, PROPER, 1},
+		{"planted-300 (3 colors)", Planted(300, 3, 0.05, 8), 3, PROPER, 1},
+	};
+}
+
+// A level with adjacency's graph, the given number of colors and rules
+void MakeRuleLevel(const RuleInstance& instance, pugi::xml_document& document)
+{
+	std::ostringstream xml;
+	xml << "<colors>";
+	for (int c = 0; c < instance.colors; c++)
+		xml << "<color color=\"#" << std::hex << std::setw(6)
+			<< std::setfill('0') << 0x100000 * (c+1) << std::dec
+			<< "\" name=\"color" << c << "\"/>";
+	xml << "</colors><graph>";
+	for (int v = 0; v < instance.adjacency.Size(); v++)
+		xml << "<vertex x=\"0\" y=\"0\" id=\"v" << v << "\"/>";
+	for (int u = 0; u < instance.adjacency.Size(); u++)
+		for (int v : instance.adjacency.Neighbors(u))
+			if (u < v)
+				xml << "<edge v1=\"v" << u << "\" v2=\"v" << v << "\"/>";
+	xml << "</graph><rules>" << instance.rules << "</rules>";
+	if (!document.load_string(xml.str().c_str()))
+		utils::errors::Die("Could not make a level for " + instance.name);
+}
+
+// Solves the rules of a level by recoloring its graph, and checks the answer
+// against is_solvable (-1 if unknown). Prints a row of the table, and returns
+// false if the answer was wrong.
+bool SolveRules(gui::Window* window, const std::string& name,
+	const pugi::xml_document& document, int is_solvable, double seconds)
+{
+	LevelContext context;
+	ColorLoader color_loader(context);
+	color_loader.LoadDocument(document);
+	GlobalLoader global_loader;
+	global_loader.LoadDocument(document);
+	RuleLoader rule_loader;
+	rule_loader.LoadDocument(document, color_loader);
+	gui::Viewport viewport_position;
+	Graph graph(context, window, viewport_position);
+	GraphLoader(color_loader, global_loader).LoadDocument(document, graph);
+
+	RuleSolver::Limits limits;
+	limits.max_seconds = seconds;
+	RuleSolver::Result result =
+		RuleSolver(graph, rule_loader, context.colors).Solve(limits);
+	const char* status;
+	bool is_correct;
+	switch (result.status)
+	{
+	case RuleSolver::Status::SOLVED:
+		status = "solved";
+		RuleSolver::Apply(result, graph);
+		is_correct = is_solvable != 0 && rule_loader.IsValid(graph);
+		break;
+	case RuleSolver::Status::INFEASIBLE:
+		status = "infeasible";
+		is_correct = is_solvable != 1;
+		break;
+	default:
+		status = "unknown";
+		is_correct = is_solvable == -1;
+		break;
+	}
+	std::cout << std::left << std::setw(36) << name
+		<< std::right << std::setw(6) << graph.V() << std::setw(8) << graph.E()
+		<< std::setw(12) << status << std::setw(12) << result.nodes
+		<< std::setw(10) << std::fixed << std::setprecision(3)
+		<< result.seconds << std::endl;
+	if (!is_correct)
+		std::cout << "Incorrect result for " << name << std::endl;
+	return is_correct;
+}
+
+// Runs TabuCol with a PointScorer on each level's starting graph, for the
+// proper vertex coloring with the most points, and prints a table. Returns
+// false if the history of the best points ever goes down.
+bool ColorLevels()
+{
+	bool is_correct = true;
+	std::cout << std::endl << std::left << std::setw(36) << "level"
+		<< std::right << std::setw(6) << "V"
+		<< std::setw(8) << "start" << std::setw(8) << "best"
+		<< std::setw(10) << "samples" << std::setw(10) << "to best"
+		<< std::endl;
+	gui::Window window(800, 600);
+	for (const std::string& level : ListLevels())
+	{
+		size_t slash = level.find('/');
+		LevelOptimizer optimizer(&window, level.substr(0, slash),
+			level.substr(slash + 1));
+		TabuCol::Result result = optimizer.ColorVertices(TABU_SECONDS);
+		if (result.history.empty())
+			continue; // No vertices
+		const TabuCol::Sample* last_proper = nullptr;
+		for (const TabuCol::Sample& sample : result.history)
+		{
+			if (sample.conflicts != 0) continue;
+			if (last_proper != nullptr && sample.score < last_proper->score)
+				is_correct = false;
+			last_proper = &sample;
+		}
+		std::cout << std::left << std::setw(36) << level
+			<< std::right << std::setw(6) << result.coloring.size()
+			<< std::setw(8) << result.history.front().score
+			<< std::setw(8) << result.score
+			<< std::setw(10) << result.history.size()
+			<< std::setw(10) << std::fixed << std::setprecision(3)
+			<< result.history.back().seconds << std::endl;
+	}
+	if (!is_correct)
+		std::cout << "TabuCol's best points went down." << std::endl;
+	return is_correct;
+}
+
+} // namespace
+
+int RunColoringBenchmark(const std::vector<std::string>& files,
+	double seconds_per_instance, int threads)
+{
+	std::vector<Instance> instances;
+	if (files.empty())
+		instances = BuiltinInstances();
+	for (const std::string& file : files)
+	{
+		std::ifstream in(file);
+		if (!in)
+			utils::errors::Die("Could not open " + file);
+		instances.push_back({file, Adjacency::FromDIMACS(in, file), -1});
+	}
+
+	int status = 0;
+	std::cout << std::left << std::setw(24) << "instance"
+		<< std::right << std::setw(6) << "V" << std::setw(8) << "E"
+		<< std::setw(6) << "lb" << std::setw(6) << "ub" << std::setw(6) << "opt"
+		<< std::setw(12) << "nodes" << std::setw(10) << "seconds"
+		<< std::setw(12) << "nodes/s" << std::setw(6) << "tabu"
+		<< std::setw(10) << "to best" << std::endl;
+	for (const Instance& instance : instances)
+	{
+		ChromaticSolver::Limits limits;
+		limits.max_seconds = seconds_per_instance;
+		ChromaticSolver::Result result;
+		if (threads == 1)
+		{
+			result = ChromaticSolver(instance.adjacency).Solve(limits);
+		}
+		else
+		{
+			ParallelChromaticSolver::Options options;
+			options.threads = threads;
+			options.limits = limits;
+			result = ParallelChromaticSolver(instance.adjacency).Solve(options);
+		}
+		TabuCol::Options tabu_options;
+		tabu_options.max_seconds = TABU_SECONDS;
+		TabuCol::Result tabu = TabuCol(instance.adjacency).Run(tabu_options);
+		// When the best coloring was found
+		double tabu_seconds = tabu.history.empty() ? 0
+			: tabu.history.back().seconds;
+		std::cout << std::left << std::setw(24) << instance.name
+			<< std::right << std::setw(6) << instance.adjacency.Size()
+			<< std::setw(8) << instance.adjacency.EdgeCount()
+			<< std::setw(6) << result.lower_bound
+			<< std::setw(6) << result.upper_bound
+			<< std::setw(6) << (result.optimal ? "yes" : "no")
+			<< std::setw(12) << result.nodes
+			<< std::setw(10) << std::fixed << std::setprecision(3) << result.seconds
+			<< std::setw(12) << std::setprecision(0)
+			<< (result.seconds > 0 ? result.nodes / result.seconds : 0)
+			<< std::setw(6) << tabu.colors << std::setw(10)
+			<< std::setprecision(3) << tabu_seconds << std::endl;
+		bool wrong = !IsProperColoring(instance.adjacency, result.coloring)
+			|| NumberOfColors(result.coloring) != result.upper_bound
+			|| (instance.chromatic_number != -1
+			 && (result.lower_bound > instance.chromatic_number
+			  || result.upper_bound < instance.chromatic_number));
+		// TabuCol should reach the chromatic number of the built-in graphs.
+		wrong = wrong || tabu.conflicts != 0
+			|| !IsProperColoring(instance.adjacency, tabu.coloring)
+			|| NumberOfColors(tabu.coloring) != tabu.colors
+			|| tabu.colors < result.lower_bound
+			|| (instance.chromatic_number != -1
+			 && tabu.colors != instance.chromatic_number);
+		if (wrong)
+		{
+			std::cout << "Incorrect result for " << instance.name << std::endl;
+			status = 1;
+		}
+	}
+	if (files.empty() && !ColorLevels())
+		status = 1;
+	return status;
+}
+
+int RunGreedyBenchmark(const std::vector<std::string>& files)
+{
+	std::vector<Instance> instances;
+	if (files.empty())
+		instances = GreedyInstances();
+	for (const std::string& file : files)
+	{
+		std::ifstream in(file);
+		if (!in)
+			utils::errors::Die("Could not open " + file);
+		instances.push_back({file, Adjacency::FromDIMACS(in, file), -1});
+	}
+
+	int status = 0;
+	std::cout << "colors / milliseconds" << std::endl;
+	std::cout << std::left << std::setw(36) << "instance"
+		<< std::right << std::setw(6) << "V" << std::setw(8) << "E";
+	for (const Heuristic& heuristic : Heuristics())
+		std::cout << std::setw(16) << heuristic.name;
+	std::cout << std::endl;
+	for (const Instance& instance : instances)
+	{
+		std::cout << std::left << std::setw(36) << instance.name
+			<< std::right << std::setw(6) << instance.adjacency.Size()
+			<< std::setw(8) << instance.adjacency.EdgeCount();
+		for (const Heuristic& heuristic : Heuristics())
+		{
+			if (heuristic.needs_rows && !instance.adjacency.HasRows())
+			{
+				std::cout << std::setw(16) << "-";
+				continue;
+			}
+			std::vector<int> coloring = heuristic.color(instance.adjacency);
+			double seconds = TimeHeuristic(heuristic, instance.adjacency);
+			std::ostringstream cell;
+			cell << NumberOfColors(coloring) << " / " << std::fixed
+				<< std::setprecision(3) << seconds * 1000;
+			std::cout << std::setw(16) << cell.str();
+			if (!IsProperColoring(instance.adjacency, coloring)
+			 || (instance.chromatic_number != -1
+			  && NumberOfColors(coloring) < instance.chromatic_number))
+			{
+				std::cout << std::endl << "Incorrect " << heuristic.name
+					<< " coloring for " << instance.name << std::endl;
+				status = 1;
+			}
+		}
+		std::cout << std::endl;
+	}
+	return status;
+}
+
+int RunRuleBenchmark(std::vector<std::string> levels,
+	double seconds_per_instance)
+{
+	std::vector<RuleInstance> instances;
+	if (levels.empty())
+	{
+		instances = BuiltinRuleInstances();
+		levels = ListLevels();
+	}
+
+	int status = 0;
+	std::cout << std::left << std::setw(36) << "instance"
+		<< std::right << std::setw(6) << "V" << std::setw(8) << "E"
+		<< std::setw(12) << "status" << std::setw(12) << "nodes"
+		<< std::setw(10) << "seconds" << std::endl;
+	gui::Window window(800, 600);
+	for (const RuleInstance& instance : instances)
+	{
+		pugi::xml_document document;
+		MakeRuleLevel(instance, document);
+		if (!SolveRules(&window, instance.name, document, instance.is_solvable,
+			seconds_per_instance))
+			status = 1;
+	}
+	// Levels are solved from their starting graphs, which the player might
+	// have to add to or delete from, so any answer is possible.
+	for (const std::string& level : levels)
+	{
+		size_t slash = level.find('/');
+		if (slash == std::string::npos)
+			utils::errors::Die("Levels should be given as category/level.");
+		std::string filename = LevelOptimizer::LevelFile(
+			level.substr(0, slash), level.substr(slash + 1));
+		pugi::xml_document document;
+		if (!document.load_file(filename.c_str()))
+			utils::errors::Die("Could not load level " + filename);
+		SolveRules(&window, level, document, -1, seconds_per_instance);
+	}
+	return status;
+}
+
+} // namespace solvers
+} // namespace graphcoloring
@@ -0,0 +1,54 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_SOLVERS_BENCHMARK_H_
+#define GRAPHCOLORING_SOLVERS_BENCHMARK_H_
+
+#include <string>
+#include <vector>
+
+namespace graphcoloring {
+namespace solvers {
+
+// Runs the chromatic solver on each DIMACS .col file given (or on a built-in
+// suite of Mycielski, queen and random graphs if there are none), and prints
+// a table of bounds, search nodes and throughput to stdout. With more than one
+// thread, ParallelChromaticSolver is used (0 threads = one per core). TabuCol
+// is run on each one too, for a second, and the table shows how many colors
+// it used and when it found that coloring. Without files, TabuCol also
+// recolors the vertices of each level for the most points.
+// Returns the exit status for main.
+extern int RunColoringBenchmark(const std::vector<std::string>& files,
+	double seconds_per_instance = 10, int threads = 1);
+// Compares the greedy heuristics (colors used and time taken) on each DIMACS
+// .col file given, or on random, random geometric and level graphs if there
+// are none. Returns the exit status for main.
+extern int RunGreedyBenchmark(const std::vector<std::string>& files);
+// Solves the rules of each level given ("category/level") with RuleSolver,
+// recoloring its starting graph. With no levels, a built-in suite of
+// generated levels whose answers are known is solved first, followed by every
+// level in the game. Prints a table of results to stdout, and returns the
+// exit status for main (failure if a known answer was wrong, or a solution
+// broke the rules).
+extern int RunRuleBenchmark(std::vector<std::string> levels,
+	double seconds_per_instance = 10);
+
+} // namespace solvers
+} // namespace graphcoloring
+
+#endif // GRAPHCOLORING_SOLVERS_BENCHMARK_H_
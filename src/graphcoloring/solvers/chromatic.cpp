@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "chromatic.hpp"
+
+#include <algorithm>
+
+#include "greedy.hpp"
+
+namespace graphcoloring {
+namespace solvers {
+
+DSaturState::DSaturState(const Adjacency& adjacency, int max_colors)
+	: adjacency(adjacency), max_colors(max_colors), color(adjacency.Size(), -1),
+	  neighbor_colors((size_t)adjacency.Size() * max_colors, 0),
+	  saturation(adjacency.Size(), 0)
+{
+}
+
+void DSaturState::SetColor(int v, int c)
+{
+	color[v] = c;
+	for (int u : adjacency.Neighbors(v))
+		if (neighbor_colors[(size_t)u * max_colors + c]++ == 0)
+			saturation[u]++;
+}
+
+void DSaturState::UnsetColor(int v)
+{
+	int c = color[v];
+	color[v] = -1;
+	for (int u : adjacency.Neighbors(v))
+		if (--neighbor_colors[(size_t)u * max_colors + c] == 0)
+			saturation[u]--;
+}
+
+bool DSaturState::IsAvailable(int v, int c) const
+{
+	return neighbor_colors[(size_t)v * max_colors + c] == 0;
+}
+
+int DSaturState::SelectVertex() const
+{
+	int best = -1;
+	for (int v = 0; v < (int)color.size(); v++)
+	{
+		if (color[v] != -1) continue;
+		if (best == -1 || saturation[v] > saturation[best]
+		 || (saturation[v] == saturation[best]
+		  && adjacency.Degree(v) > adjacency.Degree(best)))
+			best = v;
+	}
+	return best;
+}
+
+const std::vector<int>& DSaturState::Coloring() const
+{
+	return color;
+}
+
+ChromaticSolver::ChromaticSolver(const Adjacency& adjacency)
+	: adjacency(adjacency), n(adjacency.Size())
+{
+}
+
+ChromaticSolver::Result ChromaticSolver::Solve()
+{
+	return Solve(Limits());
+}
+
+ChromaticSolver::Result ChromaticSolver::Solve(const Limits& limits)
+{
+	this->limits = limits;
+	start_time = std::chrono::steady_clock::now();
+	aborted = false;
+	result = InitialBounds(adjacency);
+
+	if (result.lower_bound < result.upper_bound)
+	{
+		state = std::make_unique<DSaturState>(adjacency, result.upper_bound);
+		// Any coloring can be permuted so that the clique gets colors 0..k-1.
+		for (int i = 0; i < (int)result.clique.size(); i++)
+			state->SetColor(result.clique[i], i);
+		Search(result.clique.size(), result.clique.size());
+		state = nullptr;
+	}
+	if (!aborted)
+	{
+		result.optimal = true;
+		result.lower_bound = result.upper_bound;
+	}
+	result.seconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start_time).count();
+	return result;
+}
+
+ChromaticSolver::Result ChromaticSolver::InitialBounds(
+	const Adjacency& adjacency)
+{
+	Result result;
+	result.clique = GreedyClique(adjacency);
+	result.lower_bound = result.clique.size();
+	result.coloring = BestHeuristicColoring(adjacency);
+	result.upper_bound = NumberOfColors(result.coloring);
+	result.optimal = result.lower_bound == result.upper_bound;
+	return result;
+}
+
+bool ChromaticSolver::OutOfBudget()
+{
+	if (limits.max_nodes && result.nodes >= limits.max_nodes)
+		return true;
+	if (limits.max_seconds && result.nodes % 1024 == 0)
+		return std::chrono::duration<double>(std::chrono::steady_clock::now()
+			- start_time).count() >= limits.max_seconds;
+	return false;
+}
+
+bool ChromaticSolver::Search(int colored, int colors_used)
+{
+	if (OutOfBudget())
+	{
+		aborted = true;
+		return true;
+	}
+	result.nodes++;
+	if (colored == n)
+	{
+		// Only colorings better than the upper bound are ever reached.
+		result.upper_bound = colors_used;
+		result.coloring = state->Coloring();
+		return colors_used <= result.lower_bound;
+	}
+	int v = state->SelectVertex();
+	// Only use colors which keep us below the upper bound, and at most one new one.
+	for (int c = 0; c < std::min(colors_used + 1, result.upper_bound - 1); c++)
+	{
+		if (!state->IsAvailable(v, c)) continue;
+		state->SetColor(v, c);
+		bool stop = Search(colored + 1, std::max(colors_used, c + 1));
+		state->UnsetColor(v);
+		if (stop) return true;
+	}
+	return false;
+}
+
+} // namespace solvers
+} // namespace graphcoloring
@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_SOLVERS_CHROMATIC_H_
+#define GRAPHCOLORING_SOLVERS_CHROMATIC_H_
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "adjacency.hpp"
+
+namespace graphcoloring {
+namespace solvers {
+
+// Partial coloring for DSATUR search: keeps the saturation (number of distinct
+// adjacent colors) of each vertex up to date as vertices are colored.
+class DSaturState {
+public:
+	DSaturState(const Adjacency& adjacency, int max_colors);
+	virtual ~DSaturState() {}
+	void SetColor(int v, int color);
+	void UnsetColor(int v);
+	bool IsAvailable(int v, int color) const; // No neighbor of v has color.
+	int SelectVertex() const; // Uncolored vertex with maximum saturation (then degree); -1 if none
+	const std::vector<int>& Coloring() const; // -1 for uncolored vertices
+private:
+	const Adjacency& adjacency;
+	const int max_colors; // Width of neighbor_colors
+	std::vector<int> color;
+	std::vector<int> neighbor_colors; // [v * max_colors + c] = # of neighbors of v with color c
+	std::vector<int> saturation;
+};
+
+// Exact chromatic number by DSATUR branch-and-bound. A greedy clique gives the
+// lower bound (and is pre-colored to break symmetry), and the best of the
+// greedy heuristics gives the first upper bound. If a limit is hit, the best
+// bounds found so far are returned.
+class ChromaticSolver {
+public:
+	struct Limits
+	{
+		long long max_nodes = 0; // 0 = no limit
+		double max_seconds = 0; // 0 = no limit
+	};
+	struct Result
+	{
+		int lower_bound = 0;
+		int upper_bound = 0; // Number of colors used by coloring
+		bool optimal = false; // Is upper_bound the chromatic number?
+		std::vector<int> coloring; // Color of each vertex index
+		std::vector<int> clique; // Vertex indices of the clique used for lower_bound
+		long long nodes = 0; // Search tree nodes visited
+		double seconds = 0;
+	};
+	ChromaticSolver(const Adjacency& adjacency);
+	virtual ~ChromaticSolver() {}
+	Result Solve(); // No limits
+	Result Solve(const Limits& limits);
+	static Result InitialBounds(const Adjacency& adjacency); // Clique and greedy heuristics
+private:
+	bool Search(int colored, int colors_used); // Returns true if the search should stop.
+	bool OutOfBudget();
+	const Adjacency& adjacency;
+	const int n;
+	Limits limits;
+	Result result;
+	std::chrono::steady_clock::time_point start_time;
+	bool aborted;
+	std::unique_ptr<DSaturState> state;
+};
+
+} // namespace solvers
+} // namespace graphcoloring
+
+#endif // GRAPHCOLORING_SOLVERS_CHROMATIC_H_
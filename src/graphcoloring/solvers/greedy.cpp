@@ -0,0 +1,391 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "greedy.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <tuple>
+
+namespace graphcoloring {
+namespace solvers {
+
+namespace {
+
+typedef Adjacency::word_t word_t;
+constexpr int BITS = Adjacency::WORD_BITS;
+
+// Words in a bitset of colors; no greedy coloring uses more than MaxDegree+1.
+int ColorWords(const Adjacency& adjacency)
+{
+	int max_degree = 0;
+	for (int v = 0; v < adjacency.Size(); v++)
+		max_degree = std::max(max_degree, adjacency.Degree(v));
+	return max_degree / BITS + 1;
+}
+
+int LowestFreeColor(const word_t* forbidden, int words)
+{
+	for (int w = 0; w < words; w++)
+		if (~forbidden[w])
+			return w * BITS + __builtin_ctzll(~forbidden[w]);
+	return words * BITS; // Never happens for greedy colorings.
+}
+
+word_t ColorBit(int color) // Also used for vertices
+{
+	return (word_t)1 << (color % BITS);
+}
+
+bool IsEmpty(const std::vector<word_t>& bitset)
+{
+	for (word_t word : bitset)
+		if (word)
+			return false;
+	return true;
+}
+
+int CountCommon(const word_t* row, const std::vector<word_t>& bitset)
+{
+	int count = 0;
+	for (int w = 0; w < (int)bitset.size(); w++)
+		count += __builtin_popcountll(row[w] & bitset[w]);
+	return count;
+}
+
+int CountCommon(const std::vector<int>& a, const std::vector<int>& b) // Sorted
+{
+	int count = 0;
+	for (size_t i = 0, j = 0; i < a.size() && j < b.size(); )
+	{
+		if (a[i] < b[j]) i++;
+		else if (a[i] > b[j]) j++;
+		else { count++; i++; j++; }
+	}
+	return count;
+}
+
+// GreedyClique with the sorted neighbor lists, for adjacencies without rows.
+std::vector<int> SparseGreedyClique(const Adjacency& adjacency)
+{
+	std::vector<int> best;
+	std::vector<int> candidates, common;
+	for (int seed = 0; seed < adjacency.Size(); seed++)
+	{
+		if (adjacency.Degree(seed) < (int)best.size())
+			continue; // Can't beat the best clique
+		std::vector<int> clique = {seed};
+		candidates = adjacency.Neighbors(seed);
+		while (!candidates.empty())
+		{
+			int next = -1, next_count = -1;
+			for (int v : candidates)
+			{
+				int count = CountCommon(adjacency.Neighbors(v), candidates);
+				if (count > next_count)
+				{
+					next = v;
+					next_count = count;
+				}
+			}
+			clique.push_back(next);
+			const std::vector<int>& next_neighbors = adjacency.Neighbors(next);
+			common.clear();
+			std::set_intersection(candidates.begin(), candidates.end(),
+				next_neighbors.begin(), next_neighbors.end(),
+				std::back_inserter(common));
+			candidates.swap(common);
+		}
+		if (clique.size() > best.size())
+			best = clique;
+	}
+	return best;
+}
+
+} // namespace
+
+std::vector<int> GreedyColoring(const Adjacency& adjacency,
+	const std::vector<int>& order)
+{
+	std::vector<int> coloring(adjacency.Size(), -1);
+	int words = ColorWords(adjacency);
+	std::vector<word_t> forbidden(words, 0);
+	for (int v : order)
+	{
+		for (int u : adjacency.Neighbors(v))
+			if (coloring[u] != -1)
+			{
+				int color = coloring[u];
+				forbidden[color / BITS] |= ColorBit(color);
+			}
+		coloring[v] = LowestFreeColor(forbidden.data(), words);
+		for (int u : adjacency.Neighbors(v))
+			if (coloring[u] != -1)
+				forbidden[coloring[u] / BITS] = 0;
+	}
+	return coloring;
+}
+
+std::vector<int> FirstFitColoring(const Adjacency& adjacency)
+{
+	std::vector<int> order(adjacency.Size());
+	for (int v = 0; v < adjacency.Size(); v++)
+		order[v] = v;
+	return GreedyColoring(adjacency, order);
+}
+
+std::vector<int> WelshPowellColoring(const Adjacency& adjacency)
+{
+	std::vector<int> order(adjacency.Size());
+	for (int v = 0; v < adjacency.Size(); v++)
+		order[v] = v;
+	std::stable_sort(order.begin(), order.end(), [&adjacency] (int a, int b) {
+		return adjacency.Degree(a) > adjacency.Degree(b);
+	});
+	return GreedyColoring(adjacency, order);
+}
+
+std::vector<int> SmallestLastColoring(const Adjacency& adjacency)
+{
+	int n = adjacency.Size();
+	// Buckets of vertices by their degree among the remaining vertices. A
+	// vertex is moved by adding it to its new bucket; old entries are skipped.
+	std::vector<int> degree(n);
+	std::vector<std::vector<int>> buckets(n);
+	for (int v = 0; v < n; v++)
+	{
+		degree[v] = adjacency.Degree(v);
+		buckets[degree[v]].push_back(v);
+	}
+	std::vector<bool> removed(n, false);
+	std::vector<int> order(n);
+	int smallest = 0;
+	for (int i = n-1; i >= 0; i--)
+	{
+		int v = -1;
+		while (v == -1)
+		{
+			if (buckets[smallest].empty())
+			{
+				smallest++;
+				continue;
+			}
+			int u = buckets[smallest].back();
+			buckets[smallest].pop_back();
+			if (!removed[u] && degree[u] == smallest)
+				v = u;
+		}
+		removed[v] = true;
+		order[i] = v;
+		for (int u : adjacency.Neighbors(v))
+			if (!removed[u])
+				buckets[--degree[u]].push_back(u);
+		smallest = std::max(0, smallest - 1);
+	}
+	return GreedyColoring(adjacency, order);
+}
+
+std::vector<int> DSaturColoring(const Adjacency& adjacency)
+{
+	int n = adjacency.Size();
+	int words = ColorWords(adjacency);
+	std::vector<int> coloring(n, -1);
+	std::vector<word_t> neighbor_colors(n * words, 0); // Of each vertex
+	std::vector<int> saturation(n, 0);
+	// Uncolored vertices, by (-saturation, -degree, index).
+	std::set<std::tuple<int,int,int>> queue;
+	for (int v = 0; v < n; v++)
+		queue.insert(std::make_tuple(0, -adjacency.Degree(v), v));
+	while (!queue.empty())
+	{
+		int best = std::get<2>(*queue.begin());
+		queue.erase(queue.begin());
+		int color = LowestFreeColor(&neighbor_colors[best * words], words);
+		coloring[best] = color;
+		word_t bit = ColorBit(color);
+		for (int u : adjacency.Neighbors(best))
+		{
+			word_t& u_colors =
+				neighbor_colors[u * words + color / BITS];
+			if (coloring[u] != -1 || (u_colors & bit))
+				continue;
+			u_colors |= bit;
+			int degree = adjacency.Degree(u);
+			queue.erase(std::make_tuple(-saturation[u], -degree, u));
+			saturation[u]++;
+			queue.insert(std::make_tuple(-saturation[u], -degree, u));
+		}
+	}
+	return coloring;
+}
+
+std::vector<int> RLFColoring(const Adjacency& adjacency)
+{
+	int n = adjacency.Size();
+	int words = adjacency.Words();
+	std::vector<int> coloring(n, -1);
+	std::vector<word_t> uncolored(words, 0);
+	for (int v = 0; v < n; v++)
+		uncolored[v / BITS] |= ColorBit(v);
+	std::vector<word_t> candidates(words), excluded(words);
+	for (int color = 0; !IsEmpty(uncolored); color++)
+	{
+		// candidates: can join this color class. excluded: uncolored, but
+		// adjacent to the class.
+		candidates = uncolored;
+		std::fill(excluded.begin(), excluded.end(), 0);
+		bool first = true;
+		while (!IsEmpty(candidates))
+		{
+			// The first vertex has the most uncolored neighbors; the rest
+			// have the most excluded neighbors, then the fewest candidates.
+			int best = -1, best_excluded = -1, best_candidates = 0;
+			for (int w = 0; w < words; w++)
+			{
+				for (word_t bits = candidates[w]; bits; bits &= bits-1)
+				{
+					int v = w * BITS + __builtin_ctzll(bits);
+					const word_t* row = adjacency.Row(v);
+					int v_excluded =
+						CountCommon(row, first ? uncolored : excluded);
+					int v_candidates = first ? 0 : CountCommon(row, candidates);
+					if (v_excluded > best_excluded
+					 || (v_excluded == best_excluded
+					  && v_candidates < best_candidates))
+					{
+						best = v;
+						best_excluded = v_excluded;
+						best_candidates = v_candidates;
+					}
+				}
+			}
+			coloring[best] = color;
+			word_t bit = ColorBit(best);
+			uncolored[best / BITS] &= ~bit;
+			candidates[best / BITS] &= ~bit;
+			const word_t* row = adjacency.Row(best);
+			for (int w = 0; w < words; w++)
+			{
+				excluded[w] |= row[w] & candidates[w];
+				candidates[w] &= ~row[w];
+			}
+			first = false;
+		}
+	}
+	return coloring;
+}
+
+const std::vector<Heuristic>& Heuristics()
+{
+	static const std::vector<Heuristic> heuristics = {
+		{"first-fit", FirstFitColoring},
+		{"welsh-powell", WelshPowellColoring},
+		{"smallest-last", SmallestLastColoring},
+		{"dsatur", DSaturColoring},
+		{"rlf", RLFColoring, true}
+	};
+	return heuristics;
+}
+
+std::vector<int> BestHeuristicColoring(const Adjacency& adjacency)
+{
+	std::vector<int> best;
+	for (const Heuristic& heuristic : Heuristics())
+	{
+		if (heuristic.needs_rows && !adjacency.HasRows())
+			continue;
+		std::vector<int> coloring = heuristic.color(adjacency);
+		if (best.empty() || NumberOfColors(coloring) < NumberOfColors(best))
+			best = coloring;
+	}
+	return best;
+}
+
+std::vector<int> GreedyClique(const Adjacency& adjacency)
+{
+	if (!adjacency.HasRows())
+		return SparseGreedyClique(adjacency);
+	int n = adjacency.Size();
+	// Grow a clique greedily from every vertex, always adding the candidate
+	// with the most neighbors among the remaining candidates.
+	int words = adjacency.Words();
+	std::vector<int> best;
+	std::vector<Adjacency::word_t> candidates(words);
+	for (int seed = 0; seed < n; seed++)
+	{
+		if (adjacency.Degree(seed) < (int)best.size())
+			continue; // Can't beat the best clique
+		std::vector<int> clique = {seed};
+		const Adjacency::word_t* row = adjacency.Row(seed);
+		std::copy(row, row + words, candidates.begin());
+		while (true)
+		{
+			int next = -1, next_count = -1;
+			for (int w = 0; w < words; w++)
+			{
+				for (Adjacency::word_t bits = candidates[w]; bits; bits &= bits-1)
+				{
+					int v = w * Adjacency::WORD_BITS + __builtin_ctzll(bits);
+					const Adjacency::word_t* v_row = adjacency.Row(v);
+					int count = 0;
+					for (int i = 0; i < words; i++)
+						count += __builtin_popcountll(v_row[i] & candidates[i]);
+					if (count > next_count)
+					{
+						next = v;
+						next_count = count;
+					}
+				}
+			}
+			if (next == -1)
+				break;
+			clique.push_back(next);
+			const Adjacency::word_t* next_row = adjacency.Row(next);
+			for (int w = 0; w < words; w++)
+				candidates[w] &= next_row[w];
+		}
+		if (clique.size() > best.size())
+			best = clique;
+	}
+	return best;
+}
+
+int NumberOfColors(const std::vector<int>& coloring)
+{
+	if (coloring.empty()) return 0;
+	return *std::max_element(coloring.begin(), coloring.end()) + 1;
+}
+
+bool IsProperColoring(const Adjacency& adjacency,
+	const std::vector<int>& coloring)
+{
+	if ((int)coloring.size() != adjacency.Size())
+		return false;
+	for (int v = 0; v < adjacency.Size(); v++)
+	{
+		if (coloring[v] < 0) return false;
+		for (int u : adjacency.Neighbors(v))
+			if (coloring[u] == coloring[v])
+				return false;
+	}
+	return true;
+}
+
+} // namespace solvers
+} // namespace graphcoloring
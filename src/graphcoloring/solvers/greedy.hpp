@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_SOLVERS_GREEDY_H_
+#define GRAPHCOLORING_SOLVERS_GREEDY_H_
+
+#include <vector>
+
+#include "adjacency.hpp"
+
+namespace graphcoloring {
+namespace solvers {
+
+// Colorings are vectors giving the color (0, 1, 2, ...) of each vertex index.
+// The greedy colorers below give each vertex the lowest color not used by its
+// colored neighbors (found with a bitset of forbidden colors), and differ in
+// the order in which they color the vertices.
+
+// Colors the vertices in the given order.
+extern std::vector<int> GreedyColoring(const Adjacency& adjacency,
+	const std::vector<int>& order);
+// Colors the vertices in index order. O(V+E)
+extern std::vector<int> FirstFitColoring(const Adjacency& adjacency);
+// Welsh-Powell: colors the vertices from the largest degree to the smallest.
+// O(V log V + E)
+extern std::vector<int> WelshPowellColoring(const Adjacency& adjacency);
+// Matula-Beck: repeatedly removes a vertex of smallest degree, and colors the
+// vertices in the reverse order. Uses at most degeneracy+1 colors. O(V+E)
+extern std::vector<int> SmallestLastColoring(const Adjacency& adjacency);
+// Brelaz's DSATUR heuristic: repeatedly color the vertex with the most
+// distinctly-colored neighbors (ties broken by degree) with its lowest free
+// color. O((V+E) log V)
+extern std::vector<int> DSaturColoring(const Adjacency& adjacency);
+// Leighton's recursive largest first: builds one color class at a time,
+// adding the vertex with the most neighbors which can't join the class.
+// O(V^3/64), with the adjacency bitsets, so it needs Adjacency::HasRows().
+extern std::vector<int> RLFColoring(const Adjacency& adjacency);
+typedef std::vector<int> (*heuristic_t)(const Adjacency& adjacency);
+struct Heuristic
+{
+	const char* name;
+	heuristic_t color;
+	bool needs_rows = false; // Can't be used without Adjacency::HasRows()
+};
+extern const std::vector<Heuristic>& Heuristics(); // All of the heuristics above
+// The coloring with the fewest colors out of all the heuristics which can be
+// used on adjacency.
+extern std::vector<int> BestHeuristicColoring(const Adjacency& adjacency);
+// Grows a clique greedily from each vertex, and returns the largest one found.
+// O(V^2 * V/64) with the adjacency bitsets, otherwise O(V * D^3) for maximum
+// degree D.
+extern std::vector<int> GreedyClique(const Adjacency& adjacency);
+extern int NumberOfColors(const std::vector<int>& coloring);
+extern bool IsProperColoring(const Adjacency& adjacency,
+	const std::vector<int>& coloring);
+
+} // namespace solvers
+} // namespace graphcoloring
+
+#endif // GRAPHCOLORING_SOLVERS_GREEDY_H_
@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "hintsearch.hpp"
+
+namespace graphcoloring {
+namespace solvers {
+
+gboolean DeliverHint(gpointer data)
+{
+	HintSearch* search = (HintSearch*) data;
+	search->Deliver();
+	return G_SOURCE_REMOVE;
+}
+
+HintSearch::HintSearch(const RuleLoader& rule_loader_,
+	const PointCalculator& point_calculator_,
+	const std::vector<gui::Color>& palette_,
+	std::function<void()> on_progress_)
+	: rule_loader(rule_loader_), point_calculator(point_calculator_),
+	  palette(palette_), on_progress(on_progress_),
+	  window(800, 600), probes(context, &window, viewport_position),
+	  thread(&HintSearch::Run, this)
+{}
+
+HintSearch::~HintSearch()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wakeup.notify_one();
+	thread.join();
+	if (deliver_source)
+		g_source_remove(deliver_source);
+}
+
+void HintSearch::Submit(std::shared_ptr<const Graph::Snapshot> snapshot)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		is_wanted = true;
+		if (!has_submitted || snapshot->revision != last_submitted)
+		{
+			has_submitted = true;
+			last_submitted = snapshot->revision;
+			pending = snapshot;
+		}
+	}
+	wakeup.notify_one();
+}
+
+void HintSearch::Pause()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	is_wanted = false;
+}
+
+void HintSearch::Run()
+{
+	while (true)
+	{
+		std::shared_ptr<const Graph::Snapshot> snapshot;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wakeup.wait(lock, [this] () {
+				return stopping || (is_wanted && (pending
+					|| (state.started
+					 && state.next_candidate < state.candidates)));
+			});
+			if (stopping) return;
+			snapshot.swap(pending);
+		}
+
+		if (snapshot)
+			Restart(*snapshot);
+		else
+			Step();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		posted = state;
+		if (!deliver_source)
+			deliver_source = g_idle_add(DeliverHint, this);
+	}
+}
+
+void HintSearch::Restart(const Graph::Snapshot& snapshot)
+{
+	probes.Restore(snapshot);
+	state = State();
+	state.started = true;
+	state.revision = snapshot.revision;
+	state.candidates = (probes.V() + probes.E()) * palette.size();
+	Evaluation evaluation = Evaluate();
+	violations = evaluation.violations;
+	points = evaluation.points;
+}
+
+void HintSearch::Step()
+{
+	int candidate = state.next_candidate++;
+	int element = candidate / palette.size();
+	gui::Color color = palette[candidate % palette.size()];
+	bool is_vertex = element < probes.V();
+	Vertex* vertex = is_vertex ? probes.vertices[element] : nullptr;
+	Edge* edge = is_vertex ? nullptr : probes.edges[element - probes.V()];
+	gui::Color old_color = is_vertex ? vertex->Color() : edge->Color();
+	if (color == old_color
+	 || (is_vertex ? vertex->is_color_protected : edge->is_color_protected))
+		return;
+
+	if (is_vertex)
+		vertex->ChangeColor(color);
+	else
+		edge->ChangeColor(color);
+	Evaluation evaluation = Evaluate();
+	int new_violations = evaluation.violations;
+	int new_points = evaluation.points;
+	if (is_vertex)
+		vertex->ChangeColor(old_color);
+	else
+		edge->ChangeColor(old_color);
+
+	Hint hint;
+	hint.found = true;
+	hint.is_vertex = is_vertex;
+	hint.id = is_vertex ? vertex->id : edge->id;
+	hint.color = color;
+	hint.fixes_rules = violations > 0;
+	if (hint.fixes_rules)
+		hint.gain = violations - new_violations;
+	else if (new_violations == 0)
+		hint.gain = new_points - points;
+	if (hint.gain > 0 && (!state.best.found || hint.gain > state.best.gain))
+		state.best = hint;
+}
+
+HintSearch::Evaluation HintSearch::Evaluate()
+{
+	Evaluation evaluation;
+	if (evaluations.Find(probes.Hash(), evaluation))
+		return evaluation;
+	evaluation.violations = rule_loader.Violations(probes);
+	evaluation.points = point_calculator.GraphPoints(probes);
+	evaluations.Store(probes.Hash(), evaluation);
+	return evaluation;
+}
+
+void HintSearch::Deliver()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		latest = posted;
+		deliver_source = 0;
+	}
+	if (on_progress)
+		on_progress();
+}
+
+bool HintSearch::IsFinished(unsigned long revision) const
+{
+	return !IsStale(revision) && latest.next_candidate >= latest.candidates;
+}
+
+bool HintSearch::IsStale(unsigned long revision) const
+{
+	return !latest.started || latest.revision != revision;
+}
+
+double HintSearch::Progress(unsigned long revision) const
+{
+	if (IsStale(revision)) return 0;
+	if (latest.candidates == 0) return 1;
+	return (double)latest.next_candidate / latest.candidates;
+}
+
+const HintSearch::Hint& HintSearch::Best() const
+{
+	return latest.best;
+}
+
+} // namespace solvers
+} // namespace graphcoloring
@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_SOLVERS_HINTSEARCH_H_
+#define GRAPHCOLORING_SOLVERS_HINTSEARCH_H_
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+#include <gtk/gtk.h>
+
+#include "gui/window.hpp"
+#include "graphcoloring/graphs/graph.hpp"
+#include "graphcoloring/levels/pointcalculator.hpp"
+#include "transpositiontable.hpp"
+
+namespace graphcoloring {
+namespace solvers {
+
+// Looks for the recoloring of one vertex or edge of the player's graph which
+// helps the most: the one which fixes the most rule violations if the graph
+// is invalid, and otherwise the one which gains the most points.
+// Like ScoreWorker, the search runs on a worker thread, so that it never holds
+// up the GTK thread however big the graph is. The GTK thread submits snapshots
+// of the graph while a hint is wanted; the worker restores each one into a
+// private copy, tries the candidates on it one at a time, and posts its
+// progress back with g_idle_add. Submitting a new revision starts the search
+// over, and Pause stops it where it is until the next Submit.
+// The loaders must not change while the search exists.
+class HintSearch {
+public:
+	struct Hint
+	{
+		bool found = false;
+		bool is_vertex = true;
+		int id = -1; // Vertex/edge ID
+		gui::Color color = 0; // What to recolor it to
+		bool fixes_rules = false; // Is gain in rule violations (not points)?
+		int gain = 0;
+	};
+	HintSearch(const RuleLoader& rule_loader,
+		const PointCalculator& point_calculator,
+		const std::vector<gui::Color>& palette,
+		std::function<void()> on_progress = nullptr); // on_progress is called on the GTK thread.
+	virtual ~HintSearch(); // Waits for the current candidate to be tried.
+	// Searches snapshot (or carries on searching it, if it's the one being
+	// searched).
+	void Submit(std::shared_ptr<const Graph::Snapshot> snapshot);
+	void Pause(); // Stops searching until the next Submit.
+	// These are about the latest progress posted, for the given revision of
+	// the graph.
+	bool IsFinished(unsigned long revision) const;
+	bool IsStale(unsigned long revision) const; // Is the progress for another revision?
+	double Progress(unsigned long revision) const; // Fraction of the candidates tried
+	const Hint& Best() const;
+private:
+	struct Evaluation
+	{
+		int violations;
+		int points; // Not counting the path, which doesn't change during a search
+	};
+	struct State
+	{
+		bool started = false;
+		unsigned long revision = 0; // Of the graph being searched
+		int candidates = 0; // (V + E) * palette size
+		int next_candidate = 0;
+		Hint best;
+	};
+	friend gboolean DeliverHint(gpointer data);
+	void Run();
+	void Restart(const Graph::Snapshot& snapshot);
+	void Step(); // Tries the next candidate.
+	Evaluation Evaluate(); // Of probes; looks it up in evaluations first.
+	void Deliver(); // Called on the GTK thread.
+	const RuleLoader& rule_loader;
+	const PointCalculator& point_calculator;
+	const std::vector<gui::Color>& palette;
+	std::function<void()> on_progress;
+	State latest; // Latest posted progress, only used by the GTK thread
+	// Only used by the worker thread:
+	gui::Window window; // For probes' callbacks, which are never called.
+	gui::Viewport viewport_position;
+	LevelContext context; // probes' own, since it's on another thread
+	Graph probes; // The copy of the graph which candidates are tried on
+	State state;
+	int violations; // Of the graph as it is
+	int points;
+	TranspositionTable<Evaluation> evaluations;
+	std::mutex mutex; // Guards everything below
+	std::condition_variable wakeup;
+	std::shared_ptr<const Graph::Snapshot> pending; // null if there's no new graph
+	unsigned long last_submitted = 0;
+	bool has_submitted = false;
+	bool is_wanted = false; // Not paused
+	State posted; // Waiting to be delivered
+	guint deliver_source = 0; // 0 if there's nothing to deliver
+	bool stopping = false;
+	std::thread thread;
+};
+
+} // namespace solvers
+} // namespace graphcoloring
+
+#endif // GRAPHCOLORING_SOLVERS_HINTSEARCH_H_
@@ -0,0 +1,567 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "leveloptimizer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "graphcoloring/graphcoloring.hpp"
+#include "graphcoloring/graphs/eulerian.hpp"
+#include "graphcoloring/levels/graphloader.hpp"
+#include "adjacency.hpp"
+#include "pointscorer.hpp"
+#include "utils/errors.hpp"
+#include "utils/filesystem.hpp"
+
+namespace graphcoloring {
+namespace solvers {
+
+LevelOptimizer::LevelOptimizer(gui::Window* window_,
+	std::string category_id_, std::string level_id_)
+	: window(window_), category_id(category_id_), level_id(level_id_),
+	  viewport_position(0, 0), graph(context, window, viewport_position),
+	  color_loader(context),
+	  path(window, graph, rule_loader, color_loader),
+	  point_calculator(value_loader, rule_loader, color_loader, path)
+{
+	LoadLevel();
+}
+
+LevelOptimizer::~LevelOptimizer() {}
+
+std::string LevelOptimizer::LevelFile(const std::string& category_id,
+	const std::string& level_id)
+{
+	return "assets/levels/" + category_id + "/" + level_id + ".xml";
+}
+
+void LevelOptimizer::LoadLevel()
+{
+	// Same as Level::LoadLevelDocument, without the save file.
+	pugi::xml_document document;
+	std::string filename = LevelFile(category_id, level_id);
+	if (!document.load_file(filename.c_str()))
+		utils::errors::Die("Could not load level " + filename);
+
+	color_loader.LoadDocument(document);
+	global_loader.LoadDocument(document);
+
+	graph.can_add_new_vertices = !global_loader.IsVertexProtected(PROTECT_ADD);
+	graph.can_add_new_edges =    !global_loader.IsEdgeProtected(PROTECT_ADD);
+	GraphLoader graph_loader(color_loader, global_loader);
+	graph_loader.LoadDocument(document, graph);
+	value_loader.LoadGraph(graph_loader);
+	value_loader.LoadColors(color_loader);
+	value_loader.LoadDocument(document);
+	rule_loader.LoadDocument(document, color_loader);
+	path.LoadFromDocument(document);
+
+	palette = context.colors;
+	if (palette.empty())
+		utils::errors::Die("Level " + filename + " has no colors.");
+}
+
+TabuCol::Result LevelOptimizer::ColorVertices(double max_seconds)
+{
+	Adjacency adjacency(graph);
+	PointScorer scorer(graph, adjacency, point_calculator, palette);
+	TabuCol::Options options;
+	options.max_seconds = max_seconds;
+	options.colors = palette.size();
+	options.fixed = scorer.FixedColors();
+	options.score = scorer;
+	return TabuCol(adjacency).Run(options);
+}
+
+int LevelOptimizer::Score(bool& is_valid)
+{
+	Evaluation evaluation;
+	if (evaluations.Find(graph.Hash(), evaluation))
+	{
+		is_valid = evaluation.is_valid;
+		return evaluation.score;
+	}
+	int violations = rule_loader.Violations(graph);
+	is_valid = violations == 0;
+	if (is_valid && path.IsPath())
+	{
+		Eulerian::Trail trail = Eulerian(graph).FindTrail();
+		if (trail.first_vertex != -1)
+			path.Replay(trail.first_vertex, trail.edges);
+	}
+	int points = point_calculator.Points(graph, false);
+	path.ResetPath();
+	evaluation.score = points - INVALID_PENALTY * violations;
+	evaluation.is_valid = is_valid;
+	evaluations.Store(graph.Hash(), evaluation);
+	return evaluation.score;
+}
+
+int LevelOptimizer::BestTrailPoints()
+{
+	if (graph.E() > MAX_TRAIL_SEARCH_EDGES) return INT_MIN;
+	int best = INT_MIN;
+	int nodes = 0;
+	std::vector<int> trail;
+	std::vector<bool> used(graph.E());
+	for (const Vertex* v : graph.vertices)
+		SearchTrails(v->id, v->id, trail, used, best, nodes);
+	path.ResetPath();
+	return best;
+}
+
+void LevelOptimizer::SearchTrails(int first, int last, std::vector<int>& trail,
+	std::vector<bool>& used, int& best, int& nodes)
+{
+	if (++nodes > MAX_TRAIL_SEARCH_NODES) return;
+	if (!trail.empty())
+	{
+		if (!path.Replay(first, trail)) return;
+		best = std::max(best, point_calculator.Points(graph, false));
+	}
+	for (int i = 0; i < graph.E(); i++)
+	{
+		const Edge* e = graph.edges[i];
+		if (used[i] || !e->HasEndpoint(last)) continue;
+		used[i] = true;
+		trail.push_back(e->id);
+		SearchTrails(first, e->OtherEndpoint(last), trail, used, best, nodes);
+		trail.pop_back();
+		used[i] = false;
+	}
+}
+
+gui::Color LevelOptimizer::RandomColor(gui::Color other)
+{
+	if (palette.size() < 2) return other;
+	gui::Color color;
+	do
+		color = palette[rng() % palette.size()];
+	while (color == other);
+	return color;
+}
+
+bool LevelOptimizer::RandomMove(Undo& undo)
+{
+	undo.type = (MoveType)(rng() % (int)MoveType::NUMBER_OF_MOVE_TYPES);
+	int V = graph.V(), E = graph.E();
+	switch (undo.type)
+	{
+	case MoveType::VERTEX_COLOR:
+	{
+		if (V == 0) return false;
+		Vertex* v = graph.vertices[rng() % V];
+		if (v->is_color_protected) return false;
+		undo.id = v->id;
+		undo.color = v->Color();
+		v->ChangeColor(RandomColor(undo.color));
+		return true;
+	}
+	case MoveType::EDGE_COLOR:
+	{
+		if (E == 0) return false;
+		Edge* e = graph.edges[rng() % E];
+		if (e->is_color_protected) return false;
+		undo.id = e->id;
+		undo.color = e->Color();
+		e->ChangeColor(RandomColor(undo.color));
+		return true;
+	}
+	case MoveType::ADD_EDGE:
+	{
+		if (!graph.can_add_new_edges || V < 2) return false;
+		const Vertex* v1 = graph.vertices[rng() % V];
+		const Vertex* v2 = graph.vertices[rng() % V];
+		if (v1 == v2 || v1->is_edge_protected || v2->is_edge_protected
+			|| graph.HasEdge(v1->id, v2->id))
+			return false;
+		undo.id = v1->id;
+		undo.id2 = v2->id;
+		int id = graph.AddEdge(v1->id, v2->id);
+		graph.GetEdgeByID(id).ChangeColor(palette[rng() % palette.size()]);
+		return true;
+	}
+	case MoveType::DELETE_EDGE:
+	{
+		if (E == 0) return false;
+		const Edge* e = graph.edges[rng() % E];
+		if (e->is_delete_protected) return false;
+		undo.id = e->from.id;
+		undo.id2 = e->to.id;
+		undo.color = e->Color();
+		undo.is_color_protected = e->is_color_protected;
+		graph.RemoveEdge(undo.id, undo.id2);
+		return true;
+	}
+	case MoveType::ADD_VERTEX:
+	{
+		if (!graph.can_add_new_vertices || V >= max_vertices) return false;
+		int x = 0, y = 0;
+		if (V > 0)
+		{
+			// Next to some vertex; positions don't affect points.
+			const Vertex* near = graph.vertices[rng() % V];
+			x = near->x + (int)(rng() % 201) - 100;
+			y = near->y + (int)(rng() % 201) - 100;
+		}
+		undo.id = graph.AddVertex(x, y);
+		graph.GetVertexByID(undo.id).ChangeColor(
+			palette[rng() % palette.size()]);
+		// Connect it to a few vertices, since isolated vertices rarely help.
+		int connections = graph.can_add_new_edges && V > 0 ? rng() % 4 : 0;
+		for (int i = 0; i < connections; i++)
+		{
+			const Vertex* other = graph.vertices[rng() % V];
+			if (other->is_edge_protected || graph.HasEdge(undo.id, other->id))
+				continue;
+			int id = graph.AddEdge(undo.id, other->id);
+			graph.GetEdgeByID(id).ChangeColor(palette[rng() % palette.size()]);
+		}
+		return true;
+	}
+	case MoveType::DELETE_VERTEX:
+	{
+		if (V == 0) return false;
+		const Vertex* v = graph.vertices[rng() % V];
+		if (v->is_delete_protected) return false;
+		snapshot = graph.GetSnapshot();
+		graph.RemoveVertex(v->id);
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+void LevelOptimizer::UndoMove(const Undo& undo)
+{
+	switch (undo.type)
+	{
+	case MoveType::VERTEX_COLOR:
+		graph.GetVertexByID(undo.id).ChangeColor(undo.color);
+		break;
+	case MoveType::EDGE_COLOR:
+		graph.GetEdgeByID(undo.id).ChangeColor(undo.color);
+		break;
+	case MoveType::ADD_EDGE:
+		graph.RemoveEdge(undo.id, undo.id2);
+		break;
+	case MoveType::DELETE_EDGE:
+	{
+		Edge& e = graph.GetEdgeByID(graph.AddEdge(undo.id, undo.id2));
+		e.ChangeColor(undo.color);
+		e.is_color_protected = undo.is_color_protected;
+		break;
+	}
+	case MoveType::ADD_VERTEX:
+		graph.RemoveVertex(undo.id);
+		break;
+	case MoveType::DELETE_VERTEX:
+		path.ResetPath(); // As in ReadGraph
+		graph.Restore(*snapshot);
+		snapshot = nullptr;
+		break;
+	default:
+		break;
+	}
+}
+
+void LevelOptimizer::WriteGraph(pugi::xml_document& document, int points) const
+{
+	document.reset();
+	pugi::xml_node graph_node = document.append_child("graph");
+	graph_node.append_attribute("points") = points;
+	GraphLoader graph_loader(color_loader, global_loader);
+	graph_loader.WriteGraph(graph, graph_node);
+}
+
+void LevelOptimizer::ReadGraph(const pugi::xml_document& document)
+{
+	// Same as Level::Load
+	path.ResetPath();
+	graph.Clear();
+	GraphLoader graph_loader(color_loader, global_loader);
+	graph_loader.LoadDocument(document, graph);
+}
+
+LevelOptimizer::Result LevelOptimizer::Optimize(const Options& options)
+{
+	typedef std::chrono::steady_clock clock;
+	clock::time_point start = clock::now();
+	rng.seed(options.seed);
+	max_vertices = graph.V() + options.extra_vertices;
+
+	Result result;
+	result.category_id = category_id;
+	result.level_id = level_id;
+	result.objective = value_loader.ObjectivePoints(graph);
+
+	result.initial_points = point_calculator.Points(graph); // As shown in the game
+	bool is_valid;
+	int score = Score(is_valid);
+	result.is_valid = is_valid;
+	result.best_points = result.initial_points;
+	WriteGraph(witness, result.best_points);
+
+	// Annealing temperature, in points, from TEMPERATURE_START down to
+	// TEMPERATURE_END over the time budget.
+	const double TEMPERATURE_START = 4, TEMPERATURE_END = 0.05;
+	std::uniform_real_distribution<double> uniform(0, 1);
+	double seconds = 0;
+	for (long long attempts = 1; seconds < options.max_seconds; attempts++)
+	{
+		if ((attempts & 63) == 0)
+			seconds = std::chrono::duration<double>(clock::now() - start).count();
+		Undo undo;
+		if (!RandomMove(undo)) continue;
+		result.moves++;
+
+		bool new_is_valid;
+		int new_score = Score(new_is_valid);
+		if (new_is_valid
+			&& (!result.is_valid || new_score > result.best_points))
+		{
+			result.is_valid = true;
+			result.best_points = new_score;
+			WriteGraph(witness, new_score);
+		}
+
+		double temperature = TEMPERATURE_START * std::pow(
+			TEMPERATURE_END / TEMPERATURE_START, seconds / options.max_seconds);
+		if (new_score >= score
+			|| uniform(rng) < std::exp((new_score - score) / temperature))
+			score = new_score;
+		else
+			UndoMove(undo);
+	}
+
+	// Check the witness the way the game would load it.
+	ReadGraph(witness);
+	if (result.is_valid)
+	{
+		result.best_points = Score(is_valid);
+		if (!is_valid)
+			utils::errors::Die("Invalid witness for level " + category_id + "/"
+				+ level_id);
+		if (path.IsPath())
+		{
+			result.best_points = std::max(result.best_points, BestTrailPoints());
+			witness.child("graph").attribute("points") = result.best_points;
+		}
+	}
+	result.seconds =
+		std::chrono::duration<double>(clock::now() - start).count();
+	return result;
+}
+
+void LevelOptimizer::SaveWitness(const std::string& filename) const
+{
+	witness.save_file(filename.c_str());
+}
+
+namespace {
+
+const char* const OPTIMIZER_DIRECTORY = "saves/optimizer";
+const char* const CACHE_PATH = "saves/optimizer/cache.xml";
+
+// Looks up a level in the cache. Returns false if it isn't there, or the level
+// (or the options) changed since.
+bool FindCached(const pugi::xml_document& cache,
+	const LevelOptimizer::Options& options, time_t modified,
+	LevelOptimizer::Result& result)
+{
+	for (pugi::xml_node node : cache.child("optimizer-cache").children("level"))
+	{
+		if (result.category_id != node.attribute("category").value()
+			|| result.level_id != node.attribute("id").value())
+			continue;
+		if (node.attribute("modified").as_llong() != (long long)modified
+			|| node.attribute("seconds").as_double() != options.max_seconds
+			|| node.attribute("extra-vertices").as_int() != options.extra_vertices
+			|| node.attribute("seed").as_uint() != options.seed)
+			return false;
+		result.initial_points = node.attribute("initial").as_int();
+		result.best_points = node.attribute("best").as_int();
+		result.objective = node.attribute("objective").as_int();
+		result.moves = node.attribute("moves").as_llong();
+		result.is_valid = node.attribute("valid").as_bool();
+		return true;
+	}
+	return false;
+}
+
+void WriteCached(pugi::xml_document& cache,
+	const LevelOptimizer::Options& options, time_t modified,
+	const LevelOptimizer::Result& result)
+{
+	pugi::xml_node root = cache.child("optimizer-cache");
+	if (!root) root = cache.append_child("optimizer-cache");
+	for (pugi::xml_node node : root.children("level"))
+	{
+		if (result.category_id == node.attribute("category").value()
+			&& result.level_id == node.attribute("id").value())
+		{
+			root.remove_child(node);
+			break;
+		}
+	}
+	pugi::xml_node node = root.append_child("level");
+	node.append_attribute("category") = result.category_id.c_str();
+	node.append_attribute("id") = result.level_id.c_str();
+	node.append_attribute("modified") = (long long)modified;
+	node.append_attribute("seconds") = options.max_seconds;
+	node.append_attribute("extra-vertices") = options.extra_vertices;
+	node.append_attribute("seed") = options.seed;
+	node.append_attribute("initial") = result.initial_points;
+	node.append_attribute("best") = result.best_points;
+	node.append_attribute("objective") = result.objective;
+	node.append_attribute("moves") = result.moves;
+	node.append_attribute("valid") = result.is_valid;
+}
+
+} // namespace
+
+std::vector<std::string> ListLevels()
+{
+	pugi::xml_document document;
+	if (!document.load_file("assets/levels/level-list.xml"))
+		utils::errors::Die("Could not load level list.");
+	std::vector<std::string> levels;
+	for (pugi::xml_node category :
+		document.child("category-listing").children("category"))
+	{
+		std::string category_id = category.attribute("id").value();
+		for (pugi::xml_node level : category.children("level"))
+			levels.push_back(category_id + "/" + level.attribute("id").value());
+	}
+	return levels;
+}
+
+namespace {
+
+const char* Status(const LevelOptimizer::Result& result)
+{
+	if (!result.is_valid) return "unsolved";
+	if (result.initial_points >= result.objective) return "trivial";
+	if (result.best_points < result.objective) return "unreached";
+	if (result.best_points > result.objective) return "exceeded";
+	return "ok";
+}
+
+} // namespace
+
+int RunLevelOptimizer(std::vector<std::string> levels, int threads,
+	const LevelOptimizer::Options& options)
+{
+	if (levels.empty()) levels = ListLevels();
+	int n = levels.size();
+	if (threads < 1) threads = std::thread::hardware_concurrency();
+	threads = std::max(1, std::min(threads, n));
+
+	utils::filesystem::create_directory(OPTIMIZER_DIRECTORY);
+	pugi::xml_document cache;
+	cache.load_file(CACHE_PATH);
+
+	std::vector<LevelOptimizer::Result> results(n);
+	std::vector<time_t> modified(n);
+	std::vector<bool> cached(n);
+	for (int i = 0; i < n; i++)
+	{
+		size_t slash = levels[i].find('/');
+		if (slash == std::string::npos)
+			utils::errors::Die("Levels should be given as category/level, not "
+				+ levels[i]);
+		results[i].category_id = levels[i].substr(0, slash);
+		results[i].level_id = levels[i].substr(slash + 1);
+		std::string directory = std::string(OPTIMIZER_DIRECTORY) + "/"
+			+ results[i].category_id;
+		utils::filesystem::create_directory(directory);
+		modified[i] = utils::filesystem::modification_time(
+			LevelOptimizer::LevelFile(results[i].category_id,
+			results[i].level_id));
+		if (modified[i] == -1)
+			utils::errors::Die("No such level: " + levels[i]);
+		cached[i] = FindCached(cache, options, modified[i], results[i])
+			&& utils::filesystem::modification_time(
+			directory + "/" + results[i].level_id + ".xml") != -1;
+	}
+
+	// Each worker gets its own window, for graphs to register their
+	// callbacks with.
+	std::vector<std::unique_ptr<gui::Window>> windows;
+	for (int t = 0; t < threads; t++)
+		windows.emplace_back(new gui::Window(800, 600));
+
+	std::atomic<int> next_level(0);
+	auto worker = [&] (int t) {
+		for (int i; (i = next_level++) < n; )
+		{
+			if (cached[i]) continue;
+			LevelOptimizer optimizer(windows[t].get(), results[i].category_id,
+				results[i].level_id);
+			results[i] = optimizer.Optimize(options);
+			optimizer.SaveWitness(std::string(OPTIMIZER_DIRECTORY) + "/"
+				+ results[i].category_id + "/" + results[i].level_id + ".xml");
+		}
+	};
+	std::vector<std::thread> pool;
+	for (int t = 1; t < threads; t++)
+		pool.emplace_back(worker, t);
+	worker(0);
+	for (std::thread& thread : pool)
+		thread.join();
+
+	int unreached = 0;
+	std::cout << std::left << std::setw(36) << "level"
+		<< std::right << std::setw(10) << "initial" << std::setw(10) << "best"
+		<< std::setw(10) << "objective" << std::setw(10) << "moves"
+		<< std::setw(10) << "seconds" << "  status" << std::endl;
+	for (int i = 0; i < n; i++)
+	{
+		const LevelOptimizer::Result& result = results[i];
+		if (!cached[i])
+			WriteCached(cache, options, modified[i], result);
+		if (!result.is_valid || result.best_points < result.objective)
+			unreached++;
+		std::cout << std::left << std::setw(36) << levels[i]
+			<< std::right << std::setw(10) << result.initial_points
+			<< std::setw(10) << result.best_points
+			<< std::setw(10) << result.objective
+			<< std::setw(10) << result.moves << std::setw(10);
+		if (cached[i])
+			std::cout << "cached";
+		else
+			std::cout << std::fixed << std::setprecision(2) << result.seconds;
+		std::cout << "  " << Status(result) << std::endl;
+	}
+	cache.save_file(CACHE_PATH);
+	std::cout << unreached << " of " << n << " objectives not reached."
+		<< std::endl;
+	return unreached == 0 ? 0 : 1;
+}
+
+} // namespace solvers
+} // namespace graphcoloring
@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_SOLVERS_LEVELOPTIMIZER_H_
+#define GRAPHCOLORING_SOLVERS_LEVELOPTIMIZER_H_
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gui/window.hpp"
+#include "graphcoloring/graphs/graph.hpp"
+#include "graphcoloring/levels/globalloader.hpp"
+#include "graphcoloring/levels/pointcalculator.hpp"
+#include "tabucol.hpp"
+#include "transpositiontable.hpp"
+
+namespace graphcoloring {
+namespace solvers {
+
+// Searches for the highest scoring graph a player could make in a level, to
+// check that its objective is reachable (and not reached from the start).
+// Moves are the ones the game allows: recoloring vertices and edges, and
+// adding and deleting them, wherever the level's protections permit. Graphs
+// which break the rules are penalized for each rule broken, and never count
+// as a best. Levels with a path get the points of an Eulerian trail, if the
+// graph has one. The search is simulated annealing on the points.
+class LevelOptimizer {
+public:
+	struct Options
+	{
+		double max_seconds = 5;
+		int extra_vertices = 10; // How many vertices can be added
+		unsigned seed = 0;
+	};
+	struct Result
+	{
+		std::string category_id;
+		std::string level_id;
+		int initial_points = 0; // What the player starts with
+		int best_points = 0; // Points of the witness, checked by reloading it
+		bool is_valid = false; // Was a graph following the rules found?
+		int objective = 0;
+		long long moves = 0;
+		double seconds = 0;
+	};
+	LevelOptimizer(gui::Window* window, std::string category_id,
+		std::string level_id);
+	virtual ~LevelOptimizer();
+	Result Optimize(const Options& options);
+	// Recolors the vertices of the level's starting graph (so call this
+	// before Optimize) with TabuCol and a PointScorer, looking for the proper
+	// vertex coloring with the most points. The graph is left as it was.
+	TabuCol::Result ColorVertices(double max_seconds);
+	// Saves the best graph found, in the same format as the game's saves.
+	void SaveWitness(const std::string& filename) const;
+	static std::string LevelFile(const std::string& category_id,
+		const std::string& level_id);
+private:
+	enum class MoveType
+	{
+		VERTEX_COLOR,
+		EDGE_COLOR,
+		ADD_EDGE,
+		DELETE_EDGE,
+		ADD_VERTEX,
+		DELETE_VERTEX,
+		NUMBER_OF_MOVE_TYPES
+	};
+	struct Evaluation
+	{
+		int score;
+		bool is_valid;
+	};
+	struct Undo
+	{
+		MoveType type;
+		int id, id2; // Vertex/edge ID (or the endpoints of an edge)
+		gui::Color color;
+		bool is_color_protected, is_delete_protected;
+	};
+	static constexpr int INVALID_PENALTY = 100; // Per rule violation
+	// Levels whose paths needn't be Eulerian get an exhaustive search over
+	// the witness's trails, if it is small enough.
+	static constexpr int MAX_TRAIL_SEARCH_EDGES = 16;
+	static constexpr int MAX_TRAIL_SEARCH_NODES = 1000000;
+	void LoadLevel();
+	int Score(bool& is_valid); // Points, minus penalties for invalid graphs
+	int BestTrailPoints(); // INT_MIN if there are too many edges
+	void SearchTrails(int first, int last, std::vector<int>& trail,
+		std::vector<bool>& used, int& best, int& nodes);
+	bool RandomMove(Undo& undo); // Returns false if the move isn't possible.
+	void UndoMove(const Undo& undo);
+	void WriteGraph(pugi::xml_document& document, int points) const;
+	void ReadGraph(const pugi::xml_document& document);
+	gui::Color RandomColor(gui::Color other); // A palette color other than other
+	gui::Window* const window;
+	const std::string category_id;
+	const std::string level_id;
+	gui::Viewport viewport_position;
+	LevelContext context;
+	Graph graph;
+	ColorLoader color_loader;
+	GlobalLoader global_loader;
+	ValueLoader value_loader;
+	RuleLoader rule_loader;
+	Path path;
+	PointCalculator point_calculator;
+	std::vector<gui::Color> palette;
+	int max_vertices;
+	std::mt19937 rng;
+	// For undoing vertex deletions. Restoring it keeps the IDs, and so the
+	// hash, of the graph before the move.
+	std::shared_ptr<const Graph::Snapshot> snapshot;
+	pugi::xml_document witness;
+	TranspositionTable<Evaluation> evaluations; // Scores of states already visited
+};
+
+// "category/level" for every level in the game, in order.
+extern std::vector<std::string> ListLevels();
+
+// Optimizes each level ("category/level") on a pool of threads, saving the
+// witnesses in saves/optimizer/. Results are cached there too, and levels
+// whose files haven't changed since (with the same options) are skipped.
+// Prints a report, and returns the exit status for main.
+extern int RunLevelOptimizer(std::vector<std::string> levels, int threads,
+	const LevelOptimizer::Options& options);
+
+} // namespace solvers
+} // namespace graphcoloring
+
+#endif // GRAPHCOLORING_SOLVERS_LEVELOPTIMIZER_H_
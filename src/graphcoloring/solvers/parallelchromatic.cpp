@@ -0,0 +1,278 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "parallelchromatic.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace graphcoloring {
+namespace solvers {
+
+ParallelChromaticSolver::ParallelChromaticSolver(const Adjacency& adjacency)
+	: adjacency(adjacency), n(adjacency.Size())
+{
+}
+
+ChromaticSolver::Result ParallelChromaticSolver::Solve()
+{
+	return Solve(Options());
+}
+
+ChromaticSolver::Result ParallelChromaticSolver::Solve(const Options& options)
+{
+	this->options = options;
+	if (this->options.threads <= 0)
+		this->options.threads = std::max(1u, std::thread::hardware_concurrency());
+	start_time = std::chrono::steady_clock::now();
+	result = ChromaticSolver::InitialBounds(adjacency);
+	upper_bound = result.upper_bound;
+	stop = false;
+	aborted = false;
+	pending_tasks = 0;
+	idle_workers = 0;
+	total_nodes = 0;
+
+	if (result.lower_bound < result.upper_bound)
+	{
+		workers.clear();
+		for (int i = 0; i < this->options.threads; i++)
+		{
+			workers.push_back(std::make_unique<Worker>());
+			Worker& worker = *workers.back();
+			worker.state = std::make_unique<DSaturState>(adjacency,
+				result.upper_bound);
+			// Any coloring can be permuted so that the clique gets colors 0..k-1.
+			for (int j = 0; j < (int)result.clique.size(); j++)
+				worker.state->SetColor(result.clique[j], j);
+			worker.frames.resize(n);
+			worker.rng.seed(options.seed + i);
+		}
+		Task root;
+		root.colors_used = result.clique.size();
+		PushTask(*workers[0], root);
+
+		std::vector<std::thread> threads;
+		for (int i = 1; i < this->options.threads; i++)
+			threads.push_back(std::thread(&ParallelChromaticSolver::Work, this, i));
+		Work(0);
+		for (std::thread& thread : threads)
+			thread.join();
+		workers.clear();
+	}
+	result.nodes = total_nodes;
+	if (!aborted)
+	{
+		result.optimal = true;
+		result.lower_bound = result.upper_bound;
+	}
+	result.seconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start_time).count();
+	return result;
+}
+
+void ParallelChromaticSolver::Work(int index)
+{
+	Worker& worker = *workers[index];
+	bool idle = false;
+	Task task;
+	while (!stop)
+	{
+		if (PopTask(worker, task) || StealTask(index, task))
+		{
+			if (idle)
+			{
+				idle = false;
+				idle_workers--;
+			}
+			RunTask(worker, task);
+			pending_tasks--;
+		}
+		else
+		{
+			if (!idle)
+			{
+				idle = true;
+				idle_workers++;
+			}
+			// Tasks are only added by running tasks, so if there are none,
+			// the search is over.
+			if (pending_tasks == 0)
+				break;
+			std::this_thread::yield();
+		}
+	}
+	if (idle)
+		idle_workers--;
+	total_nodes += worker.nodes;
+	worker.nodes = 0;
+}
+
+bool ParallelChromaticSolver::PopTask(Worker& worker, Task& task)
+{
+	std::lock_guard<std::mutex> lock(worker.mutex);
+	if (worker.tasks.empty())
+		return false;
+	task = std::move(worker.tasks.back());
+	worker.tasks.pop_back();
+	return true;
+}
+
+bool ParallelChromaticSolver::StealTask(int thief, Task& task)
+{
+	int threads = workers.size();
+	if (threads == 1)
+		return false;
+	int first = workers[thief]->rng() % threads;
+	for (int i = 0; i < threads; i++)
+	{
+		int victim = (first + i) % threads;
+		if (victim == thief) continue;
+		Worker& worker = *workers[victim];
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		if (worker.tasks.empty()) continue;
+		// The oldest tasks are the shallowest, so they're likely the largest.
+		task = std::move(worker.tasks.front());
+		worker.tasks.pop_front();
+		return true;
+	}
+	return false;
+}
+
+void ParallelChromaticSolver::PushTask(Worker& worker, Task task)
+{
+	pending_tasks++;
+	std::lock_guard<std::mutex> lock(worker.mutex);
+	worker.tasks.push_back(std::move(task));
+}
+
+void ParallelChromaticSolver::RunTask(Worker& worker, const Task& task)
+{
+	if (task.colors_used >= upper_bound)
+		return; // A better coloring was found since this task was made.
+	for (const std::pair<int,int>& assignment : task.assignments)
+	{
+		worker.state->SetColor(assignment.first, assignment.second);
+		worker.path.push_back(assignment);
+	}
+	worker.task_length = worker.path.size();
+	Search(worker, 0, task.colors_used);
+	for (auto it = worker.path.rbegin(); it != worker.path.rend(); it++)
+		worker.state->UnsetColor(it->first);
+	worker.path.clear();
+}
+
+void ParallelChromaticSolver::Search(Worker& worker, int depth,
+	int colors_used)
+{
+	if (++worker.nodes % 1024 == 0)
+		FlushNodes(worker);
+	if (stop.load(std::memory_order_relaxed))
+		return;
+	if ((int)(result.clique.size() + worker.path.size()) == n)
+	{
+		Improve(worker, colors_used);
+		return;
+	}
+	int v = worker.state->SelectVertex();
+	Frame& frame = worker.frames[depth];
+	frame.vertex = v;
+	frame.colors_used = colors_used;
+	frame.untried.clear();
+	// Only use colors which keep us below the upper bound, and at most one new one.
+	int limit = std::min(colors_used + 1,
+		upper_bound.load(std::memory_order_relaxed) - 1);
+	for (int c = limit - 1; c >= 0; c--)
+		if (worker.state->IsAvailable(v, c))
+			frame.untried.push_back(c);
+
+	while (!worker.frames[depth].untried.empty())
+	{
+		int c = worker.frames[depth].untried.back();
+		worker.frames[depth].untried.pop_back();
+		if (c >= upper_bound.load(std::memory_order_relaxed) - 1)
+			continue;
+		if (idle_workers.load(std::memory_order_relaxed) > 0)
+			Donate(worker, depth);
+		worker.state->SetColor(v, c);
+		worker.path.push_back(std::make_pair(v, c));
+		Search(worker, depth + 1, std::max(colors_used, c + 1));
+		worker.path.pop_back();
+		worker.state->UnsetColor(v);
+		if (stop.load(std::memory_order_relaxed))
+			return;
+	}
+}
+
+void ParallelChromaticSolver::Donate(Worker& worker, int depth)
+{
+	{
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		if (!worker.tasks.empty())
+			return; // There's already work to steal.
+	}
+	for (int d = 0; d <= depth; d++)
+	{
+		Frame& frame = worker.frames[d];
+		if (frame.untried.empty()) continue;
+		// Choices at depth d come after the first task_length + d in the path.
+		assignments_t prefix(worker.path.begin(),
+			worker.path.begin() + worker.task_length + d);
+		for (int c : frame.untried)
+		{
+			Task task;
+			task.assignments = prefix;
+			task.assignments.push_back(std::make_pair(frame.vertex, c));
+			task.colors_used = std::max(frame.colors_used, c + 1);
+			PushTask(worker, std::move(task));
+		}
+		frame.untried.clear();
+		return;
+	}
+}
+
+void ParallelChromaticSolver::Improve(const Worker& worker, int colors_used)
+{
+	std::lock_guard<std::mutex> lock(result_mutex);
+	if (colors_used >= upper_bound)
+		return;
+	upper_bound = colors_used;
+	result.upper_bound = colors_used;
+	result.coloring = worker.state->Coloring();
+	if (colors_used <= result.lower_bound)
+		stop = true; // Can't do any better than the clique.
+}
+
+void ParallelChromaticSolver::FlushNodes(Worker& worker)
+{
+	long long nodes = total_nodes += worker.nodes;
+	worker.nodes = 0;
+	const ChromaticSolver::Limits& limits = options.limits;
+	bool out_of_budget = (limits.max_nodes && nodes >= limits.max_nodes)
+		|| (limits.max_seconds && std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start_time).count()
+			>= limits.max_seconds);
+	if (out_of_budget)
+	{
+		aborted = true;
+		stop = true;
+	}
+}
+
+} // namespace solvers
+} // namespace graphcoloring
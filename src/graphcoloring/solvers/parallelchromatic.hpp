@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_SOLVERS_PARALLELCHROMATIC_H_
+#define GRAPHCOLORING_SOLVERS_PARALLELCHROMATIC_H_
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+
+#include "chromatic.hpp"
+
+namespace graphcoloring {
+namespace solvers {
+
+// ChromaticSolver's branch-and-bound, run on several threads. Each thread has
+// a deque of subproblems (color choices below the clique); it works from the
+// back of its own deque, and when it runs out it steals from the front of a
+// random other thread's. While some thread is idle, busy threads split off the
+// untried choices at the shallowest level of their search as new subproblems.
+// All threads prune against one shared upper bound.
+// With one thread nothing is ever split, so for a fixed seed the search is
+// deterministic (and visits the same nodes as ChromaticSolver).
+class ParallelChromaticSolver {
+public:
+	struct Options
+	{
+		int threads = 0; // 0 = one per hardware thread
+		unsigned seed = 0; // Used to choose which thread to steal from
+		ChromaticSolver::Limits limits;
+	};
+	ParallelChromaticSolver(const Adjacency& adjacency);
+	virtual ~ParallelChromaticSolver() {}
+	ChromaticSolver::Result Solve(); // Default options
+	ChromaticSolver::Result Solve(const Options& options);
+private:
+	typedef std::vector<std::pair<int,int>> assignments_t; // (vertex, color)
+	struct Task
+	{
+		assignments_t assignments; // Choices made after coloring the clique
+		int colors_used;
+	};
+	struct Frame // One level of a worker's depth-first search
+	{
+		int vertex;
+		int colors_used;
+		std::vector<int> untried; // Colors left to try, next one last
+	};
+	struct Worker
+	{
+		std::mutex mutex; // Protects tasks
+		std::deque<Task> tasks;
+		std::unique_ptr<DSaturState> state;
+		assignments_t path; // All the choices leading to the current node
+		size_t task_length; // Length of the current task's assignments
+		std::vector<Frame> frames; // Indexed by depth below the current task
+		std::mt19937 rng;
+		long long nodes = 0; // Not yet added to total_nodes
+	};
+	void Work(int index);
+	bool PopTask(Worker& worker, Task& task);
+	bool StealTask(int thief, Task& task);
+	void PushTask(Worker& worker, Task task);
+	void RunTask(Worker& worker, const Task& task);
+	void Search(Worker& worker, int depth, int colors_used);
+	void Donate(Worker& worker, int depth); // Split off untried choices
+	void Improve(const Worker& worker, int colors_used); // Found a better coloring
+	void FlushNodes(Worker& worker); // Also checks the limits.
+
+	const Adjacency& adjacency;
+	const int n;
+	Options options;
+	ChromaticSolver::Result result;
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::mutex result_mutex; // Protects result.coloring
+	std::atomic<int> upper_bound;
+	std::atomic<bool> stop; // Cooperative cancellation
+	std::atomic<bool> aborted; // Was a limit hit?
+	std::atomic<int> pending_tasks; // Tasks queued or running
+	std::atomic<int> idle_workers;
+	std::atomic<long long> total_nodes;
+	std::chrono::steady_clock::time_point start_time;
+};
+
+} // namespace solvers
+} // namespace graphcoloring
+
+#endif // GRAPHCOLORING_SOLVERS_PARALLELCHROMATIC_H_
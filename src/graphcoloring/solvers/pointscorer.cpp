@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "pointscorer.hpp"
+
+#include <algorithm>
+
+namespace graphcoloring {
+namespace solvers {
+
+PointScorer::PointScorer(Graph& graph, const Adjacency& adjacency,
+	const PointCalculator& point_calculator,
+	const std::vector<gui::Color>& palette)
+	: graph(graph), point_calculator(point_calculator), palette(palette)
+{
+	for (int v = 0; v < adjacency.Size(); v++)
+		vertices.push_back(&graph.GetVertexByID(adjacency.VertexID(v)));
+}
+
+int PointScorer::operator()(const std::vector<int>& coloring) const
+{
+	std::vector<gui::Color> old_colors;
+	for (int v = 0; v < (int)vertices.size(); v++)
+	{
+		old_colors.push_back(vertices[v]->Color());
+		vertices[v]->ChangeColor(palette.at(coloring[v])); // Does nothing if protected.
+	}
+	int points = point_calculator.Points(graph);
+	for (int v = 0; v < (int)vertices.size(); v++)
+		vertices[v]->ChangeColor(old_colors[v]);
+	return points;
+}
+
+std::vector<int> PointScorer::FixedColors() const
+{
+	std::vector<int> fixed(vertices.size(), -1);
+	for (int v = 0; v < (int)vertices.size(); v++)
+	{
+		if (!vertices[v]->is_color_protected) continue;
+		auto it = std::find(palette.begin(), palette.end(),
+			vertices[v]->Color());
+		if (it != palette.end())
+			fixed[v] = it - palette.begin();
+	}
+	return fixed;
+}
+
+} // namespace solvers
+} // namespace graphcoloring
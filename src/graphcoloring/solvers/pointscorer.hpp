@@ -0,0 +1,51 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_SOLVERS_POINTSCORER_H_
+#define GRAPHCOLORING_SOLVERS_POINTSCORER_H_
+
+#include <vector>
+
+#include "graphcoloring/levels/pointcalculator.hpp"
+#include "adjacency.hpp"
+
+namespace graphcoloring {
+namespace solvers {
+
+// Scores vertex colorings (as used by the solvers, for an Adjacency built from
+// graph) by the points the level would give: the graph is recolored with
+// palette[color] for each vertex, scored, and then restored.
+class PointScorer {
+public:
+	PointScorer(Graph& graph, const Adjacency& adjacency,
+		const PointCalculator& point_calculator,
+		const std::vector<gui::Color>& palette);
+	virtual ~PointScorer() {}
+	int operator()(const std::vector<int>& coloring) const;
+	std::vector<int> FixedColors() const; // For TabuCol: palette index of each color protected vertex
+private:
+	Graph& graph;
+	std::vector<Vertex*> vertices; // By index in adjacency
+	const PointCalculator& point_calculator;
+	const std::vector<gui::Color> palette;
+};
+
+} // namespace solvers
+} // namespace graphcoloring
+
+#endif // GRAPHCOLORING_SOLVERS_POINTSCORER_H_
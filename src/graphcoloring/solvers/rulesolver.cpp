@@ -0,0 +1,451 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "rulesolver.hpp"
+
+#include <algorithm>
+
+#include "utils/errors.hpp"
+
+namespace graphcoloring {
+namespace solvers {
+
+RuleSolver::RuleSolver(const Graph& graph, const RuleLoader& rule_loader,
+	const std::vector<gui::Color>& palette)
+	: V(graph.V()), E(graph.E())
+{
+	domain_t palette_domain = 0;
+	for (gui::Color color : palette)
+		palette_domain |= (domain_t)1 << ColorIndex(color);
+
+	std::map<int, int> vertex_indices; // Vertex ID => variable
+	for (const Vertex* v : graph.vertices)
+	{
+		vertex_indices[v->id] = vertex_ids.size();
+		vertex_ids.push_back(v->id);
+		initial_domains.push_back(v->is_color_protected
+			? (domain_t)1 << ColorIndex(v->Color()) : palette_domain);
+	}
+	for (const Edge* e : graph.edges)
+	{
+		EdgeConstraint constraint;
+		constraint.vertex1 = vertex_indices.at(e->from.id);
+		constraint.vertex2 = vertex_indices.at(e->to.id);
+		constraint.edge = V + edge_ids.size();
+		edge_constraints.push_back(constraint);
+		edge_ids.push_back(e->id);
+		initial_domains.push_back(e->is_color_protected
+			? (domain_t)1 << ColorIndex(e->Color()) : palette_domain);
+	}
+	// Every color an element can have is known now.
+	CompileEdgeRules(rule_loader);
+	CompileBoundRules(rule_loader, palette);
+	if (rule_loader.MustBeProperEdgeColoring())
+		CompileEdgeColoring(graph);
+	if (rule_loader.MustBeConnected() && !graph.IsConnected())
+		infeasible = true; // Recoloring can't change this.
+}
+
+int RuleSolver::ColorIndex(gui::Color color)
+{
+	auto it = std::find(colors.begin(), colors.end(), color);
+	if (it != colors.end())
+		return it - colors.begin();
+	if ((int)colors.size() == MAX_COLORS)
+		utils::errors::Die("Too many colors for the rule solver.");
+	colors.push_back(color);
+	return colors.size() - 1;
+}
+
+void RuleSolver::CompileEdgeRules(const RuleLoader& rule_loader)
+{
+	const std::vector<rules::EdgeRule>& edge_rules = rule_loader.EdgeRules();
+	int K = colors.size();
+	allowed.assign(K * K * K, true);
+	bool all_allowed = true;
+	for (int i = 0; i < K * K * K; i++)
+	{
+		gui::Color v1 = colors[i / (K*K)], v2 = colors[i / K % K];
+		gui::Color edge = colors[i % K];
+		for (const rules::EdgeRule& rule : edge_rules)
+			if (!rule.ObeysRule(v1, v2, edge))
+				allowed[i] = false;
+		if (!allowed[i])
+			all_allowed = false;
+	}
+	if (all_allowed)
+		return; // No need for edge constraints.
+	var_edge_constraints.resize(V + E);
+	for (int i = 0; i < (int)edge_constraints.size(); i++)
+	{
+		const EdgeConstraint& constraint = edge_constraints[i];
+		var_edge_constraints[constraint.vertex1].push_back(i);
+		if (constraint.vertex2 != constraint.vertex1)
+			var_edge_constraints[constraint.vertex2].push_back(i);
+		var_edge_constraints[constraint.edge].push_back(i);
+	}
+}
+
+void RuleSolver::CompileBoundRules(const RuleLoader& rule_loader,
+	const std::vector<gui::Color>& palette)
+{
+	for (const rules::BoundRule& rule : rule_loader.BoundRules())
+	{
+		bool vertices = rule.IsVertexRule();
+		int n = vertices ? V : E;
+		int min = rule.IsMinimum() ? rule.Bound() : 0;
+		int max = rule.IsMinimum() ? n : rule.Bound();
+		if (rule.Color() == rules::ANY_COLOR)
+		{
+			// Counts every element, whatever its color.
+			if (n < min || n > max)
+				infeasible = true;
+		}
+		else if (rule.Color() == rules::SAME_COLOR)
+		{
+			// Applies to each palette color, and (like BoundRule) to any other
+			// color an edge has.
+			for (int c = 0; c < (int)colors.size(); c++)
+			{
+				bool counted = std::find(palette.begin(), palette.end(),
+					colors[c]) != palette.end();
+				for (int e = V; e < V + E && !vertices && !counted; e++)
+					if (initial_domains[e] == (domain_t)1 << c)
+						counted = true;
+				if (counted)
+					AddCountConstraint(vertices, c, min, max);
+			}
+		}
+		else
+		{
+			auto it = std::find(colors.begin(), colors.end(), rule.Color());
+			if (it != colors.end())
+				AddCountConstraint(vertices, it - colors.begin(), min, max);
+			else if (0 < min || 0 > max) // Nothing can have this color.
+				infeasible = true;
+		}
+	}
+}
+
+void RuleSolver::CompileEdgeColoring(const Graph& graph)
+{
+	std::map<int, std::vector<int>> incident; // Vertex ID => edge variables
+	for (int e = 0; e < E; e++)
+	{
+		const Edge* edge = graph.edges[e];
+		incident[edge->from.id].push_back(V + e);
+		if (edge->to.id != edge->from.id)
+			incident[edge->to.id].push_back(V + e);
+	}
+	adjacent_edges.resize(E);
+	for (const auto& vertex_edges : incident)
+		for (int var : vertex_edges.second)
+			for (int other : vertex_edges.second)
+				if (other != var)
+					adjacent_edges[var - V].push_back(other);
+}
+
+void RuleSolver::AddCountConstraint(bool vertices, int color, int min, int max)
+{
+	CountConstraint constraint;
+	constraint.vertices = vertices;
+	constraint.color = color;
+	constraint.min = min;
+	constraint.max = max;
+	constraint.fixed = constraint.possible = 0;
+	(vertices ? vertex_counts : edge_counts).push_back(count_constraints.size());
+	count_constraints.push_back(constraint);
+}
+
+const std::vector<int>& RuleSolver::CountConstraintsOf(int var) const
+{
+	return var < V ? vertex_counts : edge_counts;
+}
+
+RuleSolver::Result RuleSolver::Solve()
+{
+	return Solve(Limits());
+}
+
+RuleSolver::Result RuleSolver::Solve(const Limits& limits)
+{
+	this->limits = limits;
+	start_time = std::chrono::steady_clock::now();
+	aborted = false;
+	result = Result();
+	if (!infeasible)
+	{
+		domains.assign(V + E, 0);
+		vertex_fixed.assign(colors.size(), 0);
+		edge_fixed.assign(colors.size(), 0);
+		for (CountConstraint& constraint : count_constraints)
+			constraint.fixed = constraint.possible = 0;
+		trail.clear();
+		var_queued.assign(V + E, false);
+		count_queued.assign(count_constraints.size(), false);
+		bool ok = true;
+		for (int var = 0; var < V + E; var++)
+			ok = SetDomain(var, initial_domains[var]) && ok;
+		// Check every count, not just the ones whose domains were set.
+		for (int i = 0; i < (int)count_constraints.size(); i++)
+		{
+			if (count_queued[i]) continue;
+			count_queued[i] = true;
+			count_queue.push_back(i);
+		}
+		if (ok && Propagate())
+			Search();
+		ClearQueues();
+	}
+	if (aborted)
+		result.status = Status::UNKNOWN;
+	else if (result.status != Status::SOLVED)
+		result.status = Status::INFEASIBLE;
+	result.seconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start_time).count();
+	return result;
+}
+
+void RuleSolver::Apply(const Result& result, Graph& graph)
+{
+	for (const auto& vertex_color : result.vertex_colors)
+		graph.GetVertexByID(vertex_color.first).ChangeColor(vertex_color.second);
+	for (const auto& edge_color : result.edge_colors)
+		graph.GetEdgeByID(edge_color.first).ChangeColor(edge_color.second);
+}
+
+void RuleSolver::ChangeDomain(int var, domain_t domain)
+{
+	domain_t old_domain = domains[var];
+	for (int i : CountConstraintsOf(var))
+	{
+		CountConstraint& constraint = count_constraints[i];
+		domain_t bit = (domain_t)1 << constraint.color;
+		constraint.possible += (bool)(domain & bit) - (bool)(old_domain & bit);
+		constraint.fixed += (domain == bit) - (old_domain == bit);
+	}
+	std::vector<int>& fixed = var < V ? vertex_fixed : edge_fixed;
+	if (__builtin_popcount(old_domain) == 1)
+		fixed[__builtin_ctz(old_domain)]--;
+	if (__builtin_popcount(domain) == 1)
+		fixed[__builtin_ctz(domain)]++;
+	domains[var] = domain;
+}
+
+bool RuleSolver::SetDomain(int var, domain_t domain)
+{
+	domain_t old_domain = domains[var];
+	if (domain == old_domain)
+		return true;
+	trail.push_back(std::make_pair(var, old_domain));
+	ChangeDomain(var, domain);
+	bool propagates = !var_edge_constraints.empty()
+		|| (!adjacent_edges.empty() && var >= V);
+	if (propagates && !var_queued[var])
+	{
+		var_queued[var] = true;
+		var_queue.push_back(var);
+	}
+	for (int i : CountConstraintsOf(var))
+	{
+		domain_t bit = (domain_t)1 << count_constraints[i].color;
+		bool changed = ((old_domain ^ domain) & bit) || domain == bit;
+		if (changed && !count_queued[i])
+		{
+			count_queued[i] = true;
+			count_queue.push_back(i);
+		}
+	}
+	return domain != 0;
+}
+
+void RuleSolver::Undo(size_t trail_size)
+{
+	while (trail.size() > trail_size)
+	{
+		ChangeDomain(trail.back().first, trail.back().second);
+		trail.pop_back();
+	}
+}
+
+bool RuleSolver::Revise(const EdgeConstraint& constraint)
+{
+	int K = colors.size();
+	domain_t domain1 = domains[constraint.vertex1];
+	domain_t domain2 = domains[constraint.vertex2];
+	domain_t edge_domain = domains[constraint.edge];
+	domain_t supported1 = 0, supported2 = 0, edge_supported = 0;
+	for (domain_t rest1 = domain1; rest1; rest1 &= rest1-1)
+	{
+		int c1 = __builtin_ctz(rest1);
+		domain_t choices2 = constraint.vertex1 == constraint.vertex2
+			? (domain_t)1 << c1 : domain2; // A loop's endpoints are the same vertex.
+		for (domain_t rest2 = choices2; rest2; rest2 &= rest2-1)
+		{
+			int c2 = __builtin_ctz(rest2);
+			const int row = (c1 * K + c2) * K;
+			for (domain_t rest_e = edge_domain; rest_e; rest_e &= rest_e-1)
+			{
+				int ce = __builtin_ctz(rest_e);
+				if (!allowed[row + ce]) continue;
+				supported1 |= (domain_t)1 << c1;
+				supported2 |= (domain_t)1 << c2;
+				edge_supported |= (domain_t)1 << ce;
+			}
+		}
+	}
+	return SetDomain(constraint.vertex1, domain1 & supported1)
+		&& SetDomain(constraint.vertex2, domain2 & supported2)
+		&& SetDomain(constraint.edge, edge_domain & edge_supported);
+}
+
+bool RuleSolver::CheckCount(CountConstraint& constraint)
+{
+	if (constraint.fixed > constraint.max || constraint.possible < constraint.min)
+		return false;
+	domain_t bit = (domain_t)1 << constraint.color;
+	int first = constraint.vertices ? 0 : V;
+	int last = constraint.vertices ? V : V + E;
+	if (constraint.fixed == constraint.max && constraint.possible > constraint.fixed)
+	{
+		// No more elements can have this color.
+		for (int var = first; var < last; var++)
+			if ((domains[var] & bit) && domains[var] != bit)
+				if (!SetDomain(var, domains[var] & ~bit))
+					return false;
+	}
+	else if (constraint.possible == constraint.min
+	      && constraint.fixed < constraint.possible)
+	{
+		// Everything which can have this color must have it.
+		for (int var = first; var < last; var++)
+			if ((domains[var] & bit) && domains[var] != bit)
+				SetDomain(var, bit);
+	}
+	return true;
+}
+
+bool RuleSolver::Propagate()
+{
+	while (!var_queue.empty() || !count_queue.empty())
+	{
+		bool ok = true;
+		if (!count_queue.empty())
+		{
+			int i = count_queue.back();
+			count_queue.pop_back();
+			count_queued[i] = false;
+			ok = CheckCount(count_constraints[i]);
+		}
+		else
+		{
+			int var = var_queue.back();
+			var_queue.pop_back();
+			var_queued[var] = false;
+			if (!var_edge_constraints.empty())
+				for (int i : var_edge_constraints[var])
+					if (!(ok = Revise(edge_constraints[i])))
+						break;
+			if (ok && var >= V && !adjacent_edges.empty()
+			 && __builtin_popcount(domains[var]) == 1)
+				for (int other : adjacent_edges[var - V])
+					if (!(ok = SetDomain(other, domains[other] & ~domains[var])))
+						break;
+		}
+		if (!ok)
+		{
+			ClearQueues();
+			return false;
+		}
+	}
+	return true;
+}
+
+void RuleSolver::ClearQueues()
+{
+	for (int var : var_queue)
+		var_queued[var] = false;
+	for (int i : count_queue)
+		count_queued[i] = false;
+	var_queue.clear();
+	count_queue.clear();
+}
+
+bool RuleSolver::OutOfBudget()
+{
+	if (limits.max_nodes && result.nodes >= limits.max_nodes)
+		return true;
+	if (limits.max_seconds && result.nodes % 1024 == 0)
+		return std::chrono::duration<double>(std::chrono::steady_clock::now()
+			- start_time).count() >= limits.max_seconds;
+	return false;
+}
+
+bool RuleSolver::Search()
+{
+	if (OutOfBudget())
+	{
+		aborted = true;
+		return true;
+	}
+	result.nodes++;
+	// Smallest domain first; break ties by the number of edge constraints.
+	int best = -1, best_size = 0;
+	for (int var = 0; var < V + E; var++)
+	{
+		int size = __builtin_popcount(domains[var]);
+		if (size <= 1) continue;
+		if (best == -1 || size < best_size || (size == best_size
+		 && !var_edge_constraints.empty()
+		 && var_edge_constraints[var].size() > var_edge_constraints[best].size()))
+		{
+			best = var;
+			best_size = size;
+		}
+	}
+	if (best == -1)
+	{
+		for (int v = 0; v < V; v++)
+			result.vertex_colors[vertex_ids[v]] = colors[__builtin_ctz(domains[v])];
+		for (int e = 0; e < E; e++)
+			result.edge_colors[edge_ids[e]] = colors[__builtin_ctz(domains[V+e])];
+		result.status = Status::SOLVED;
+		return true;
+	}
+	// Try the least used colors first, which helps to meet minimums (and
+	// avoid maximums).
+	std::vector<int> choices;
+	for (domain_t rest = domains[best]; rest; rest &= rest-1)
+		choices.push_back(__builtin_ctz(rest));
+	const std::vector<int>& fixed = best < V ? vertex_fixed : edge_fixed;
+	std::stable_sort(choices.begin(), choices.end(), [&fixed] (int a, int b) {
+		return fixed[a] < fixed[b];
+	});
+	for (int color : choices)
+	{
+		size_t trail_size = trail.size();
+		if (SetDomain(best, (domain_t)1 << color) && Propagate() && Search())
+			return true;
+		ClearQueues();
+		Undo(trail_size);
+	}
+	return false;
+}
+
+} // namespace solvers
+} // namespace graphcoloring
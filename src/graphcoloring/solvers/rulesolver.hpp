@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_SOLVERS_RULESOLVER_H_
+#define GRAPHCOLORING_SOLVERS_RULESOLVER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "graphcoloring/graphs/graph.hpp"
+#include "graphcoloring/levels/rules/ruleloader.hpp"
+
+namespace graphcoloring {
+namespace solvers {
+
+// Finds a coloring of a level's graph which obeys its rules, or proves that
+// there is none. The graph itself is fixed; only vertices and edges which are
+// not color protected are recolored, using the level's palette.
+// Each edge gets one table constraint combining all the edge rules (kept arc
+// consistent), and each bound rule becomes a counting constraint on a color.
+// For proper edge colorings, an edge's color is removed from the edges next
+// to it once it is fixed.
+// Search picks the variable with the smallest domain.
+class RuleSolver {
+public:
+	enum class Status { SOLVED, INFEASIBLE, UNKNOWN };
+	struct Limits
+	{
+		long long max_nodes = 0; // 0 = no limit
+		double max_seconds = 0; // 0 = no limit
+	};
+	struct Result
+	{
+		Status status = Status::UNKNOWN; // UNKNOWN if a limit was hit
+		std::map<int, gui::Color> vertex_colors; // Vertex ID => color
+		std::map<int, gui::Color> edge_colors; // Edge ID => color
+		long long nodes = 0;
+		double seconds = 0;
+	};
+	RuleSolver(const Graph& graph, const RuleLoader& rule_loader,
+		const std::vector<gui::Color>& palette);
+	virtual ~RuleSolver() {}
+	Result Solve(); // No limits
+	Result Solve(const Limits& limits);
+	static void Apply(const Result& result, Graph& graph); // Recolor graph with a solution
+private:
+	typedef uint32_t domain_t; // Bitset of color indices
+	static constexpr int MAX_COLORS = 32;
+	struct EdgeConstraint
+	{
+		int vertex1, vertex2, edge; // Variables
+	};
+	struct CountConstraint
+	{
+		bool vertices; // Counting vertices (otherwise edges)
+		int color; // Color index
+		int min, max;
+		int fixed; // # of variables which must have this color
+		int possible; // # of variables which could have this color
+	};
+	int ColorIndex(gui::Color color);
+	void CompileEdgeRules(const RuleLoader& rule_loader);
+	void CompileBoundRules(const RuleLoader& rule_loader,
+		const std::vector<gui::Color>& palette);
+	void CompileEdgeColoring(const Graph& graph);
+	void AddCountConstraint(bool vertices, int color, int min, int max);
+	const std::vector<int>& CountConstraintsOf(int var) const;
+	void ChangeDomain(int var, domain_t domain); // Without undo information
+	bool SetDomain(int var, domain_t domain); // Returns false if domain is empty.
+	void Undo(size_t trail_size);
+	bool Revise(const EdgeConstraint& constraint);
+	bool CheckCount(CountConstraint& constraint);
+	bool Propagate(); // Returns false on a wipeout.
+	void ClearQueues();
+	bool OutOfBudget();
+	bool Search(); // Returns true if the search should stop.
+
+	int V, E;
+	bool infeasible = false; // Known to be infeasible without searching
+	std::vector<int> vertex_ids;
+	std::vector<int> edge_ids;
+	std::vector<gui::Color> colors; // Color of each color index
+	std::vector<bool> allowed; // [(v1 * K + v2) * K + edge] for K colors
+	std::vector<EdgeConstraint> edge_constraints;
+	std::vector<std::vector<int>> var_edge_constraints;
+	std::vector<std::vector<int>> adjacent_edges; // Edge variables sharing an endpoint (for proper edge colorings)
+	std::vector<CountConstraint> count_constraints;
+	std::vector<int> vertex_counts; // Indices of count constraints on vertices
+	std::vector<int> edge_counts;
+	std::vector<domain_t> initial_domains;
+
+	std::vector<domain_t> domains; // Variables are vertices, then edges.
+	std::vector<int> vertex_fixed; // # of vertices which must have each color
+	std::vector<int> edge_fixed;
+	std::vector<std::pair<int, domain_t>> trail; // (variable, old domain)
+	std::vector<int> var_queue;
+	std::vector<bool> var_queued;
+	std::vector<int> count_queue;
+	std::vector<bool> count_queued;
+	Limits limits;
+	Result result;
+	std::chrono::steady_clock::time_point start_time;
+	bool aborted;
+};
+
+} // namespace solvers
+} // namespace graphcoloring
+
+#endif // GRAPHCOLORING_SOLVERS_RULESOLVER_H_
@@ -0,0 +1,241 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tabucol.hpp"
+
+#include <algorithm>
+
+#include "greedy.hpp"
+
+namespace graphcoloring {
+namespace solvers {
+
+TabuCol::TabuCol(const Adjacency& adjacency)
+	: adjacency(adjacency), n(adjacency.Size())
+{
+}
+
+TabuCol::Result TabuCol::Run()
+{
+	return Run(Options());
+}
+
+TabuCol::Result TabuCol::Run(const Options& options)
+{
+	this->options = options;
+	rng.seed(options.seed);
+	start_time = std::chrono::steady_clock::now();
+	iteration = 0;
+	result = Result();
+	if (n == 0)
+		return result;
+
+	// Fixed colors have to stay within the k colors too.
+	int lower_bound = GreedyClique(adjacency).size();
+	std::vector<int> initial(n, -1);
+	if (options.dsatur_start || options.colors <= 0)
+		initial = DSaturColoring(adjacency);
+	int colors = options.colors > 0 ? options.colors : NumberOfColors(initial);
+	for (int v = 0; v < n; v++)
+	{
+		if (!IsFixed(v)) continue;
+		colors = std::max(colors, options.fixed[v] + 1);
+		lower_bound = std::max(lower_bound, options.fixed[v] + 1);
+	}
+	SetColors(colors, initial);
+	Record(options.score ? options.score(coloring) : 0);
+
+	while (!OutOfBudget())
+	{
+		if (conflicts == 0)
+		{
+			if (options.score)
+			{
+				if (k == 1 || !Perturb())
+					break; // Nothing can be recolored.
+			}
+			else
+			{
+				if (k <= lower_bound) break; // Can't go any lower
+				SetColors(k - 1, coloring); // Recolor color k-1 randomly
+			}
+		}
+		else if (!Step())
+		{
+			break; // All the conflicts are between fixed vertices.
+		}
+		iteration++;
+		if (conflicts < best_conflicts)
+		{
+			best_conflicts = conflicts;
+			last_improvement = iteration;
+		}
+		if (conflicts < result.conflicts)
+		{
+			Record(options.score ? options.score(coloring) : 0);
+		}
+		else if (conflicts == 0 && options.score)
+		{
+			int score = options.score(coloring);
+			if (score > result.score)
+				Record(score);
+		}
+		else if (conflicts == 0 && NumberOfColors(coloring) < result.colors)
+		{
+			Record();
+		}
+		if (conflicts > 0
+		 && iteration - last_improvement > options.restart_iterations)
+			Randomize();
+	}
+	result.iterations = iteration;
+	result.seconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start_time).count();
+	return result;
+}
+
+bool TabuCol::IsFixed(int v) const
+{
+	return v < (int)options.fixed.size() && options.fixed[v] >= 0;
+}
+
+void TabuCol::SetColors(int new_k, const std::vector<int>& initial)
+{
+	k = new_k;
+	coloring = initial;
+	for (int v = 0; v < n; v++)
+	{
+		if (IsFixed(v))
+			coloring[v] = options.fixed[v];
+		else if (coloring[v] < 0 || coloring[v] >= k)
+			coloring[v] = rng() % k;
+	}
+	gamma.assign((size_t)n * k, 0);
+	conflicts = 0;
+	for (int v = 0; v < n; v++)
+	{
+		for (int u : adjacency.Neighbors(v))
+			gamma[(size_t)v * k + coloring[u]]++;
+		conflicts += gamma[(size_t)v * k + coloring[v]];
+	}
+	conflicts /= 2; // Each conflict was counted from both ends.
+	tabu.assign((size_t)n * k, 0);
+	best_conflicts = conflicts;
+	last_improvement = iteration;
+}
+
+void TabuCol::Randomize()
+{
+	SetColors(k, std::vector<int>(n, -1));
+}
+
+void TabuCol::Move(int v, int color)
+{
+	int old_color = coloring[v];
+	conflicts += gamma[(size_t)v * k + color] - gamma[(size_t)v * k + old_color];
+	for (int u : adjacency.Neighbors(v))
+	{
+		gamma[(size_t)u * k + old_color]--;
+		gamma[(size_t)u * k + color]++;
+	}
+	coloring[v] = color;
+}
+
+bool TabuCol::Step()
+{
+	int best_v = -1, best_color = -1, best_delta = 0, ties = 0;
+	int conflicting = 0; // # of vertices in conflicts
+	for (int v = 0; v < n; v++)
+	{
+		const int* v_gamma = &gamma[(size_t)v * k];
+		int own = v_gamma[coloring[v]];
+		if (own == 0 || IsFixed(v)) continue;
+		conflicting++;
+		for (int c = 0; c < k; c++)
+		{
+			if (c == coloring[v]) continue;
+			int delta = v_gamma[c] - own;
+			bool aspiration = conflicts + delta < best_conflicts;
+			if (tabu[(size_t)v * k + c] > iteration && !aspiration) continue;
+			if (best_v == -1 || delta < best_delta)
+			{
+				ties = 1;
+			}
+			else if (delta > best_delta || rng() % ++ties)
+			{
+				continue;
+			}
+			best_v = v;
+			best_color = c;
+			best_delta = delta;
+		}
+	}
+	if (conflicting == 0)
+		return false;
+	if (best_v == -1)
+		return true; // Every move is tabu; wait for one to expire.
+	int tenure = (options.tenure_base > 0 ? rng() % options.tenure_base : 0)
+		+ (int)(options.tenure_factor * conflicting);
+	tabu[(size_t)best_v * k + coloring[best_v]] = iteration + tenure;
+	Move(best_v, best_color);
+	return true;
+}
+
+bool TabuCol::Perturb()
+{
+	std::vector<int> free_vertices;
+	for (int v = 0; v < n; v++)
+		if (!IsFixed(v))
+			free_vertices.push_back(v);
+	if (free_vertices.empty())
+		return false;
+	int v = free_vertices[rng() % free_vertices.size()];
+	int color = (coloring[v] + 1 + rng() % (k - 1)) % k; // Any other color
+	tabu[(size_t)v * k + coloring[v]] = iteration + options.tenure_base;
+	Move(v, color);
+	return true;
+}
+
+void TabuCol::Record(int score)
+{
+	result.coloring = coloring;
+	result.colors = NumberOfColors(coloring);
+	result.conflicts = conflicts;
+	result.score = score;
+	Sample sample;
+	sample.seconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start_time).count();
+	sample.iteration = iteration;
+	sample.colors = result.colors;
+	sample.conflicts = conflicts;
+	sample.score = result.score;
+	result.history.push_back(sample);
+}
+
+bool TabuCol::OutOfBudget() const
+{
+	if (options.max_iterations && iteration >= options.max_iterations)
+		return true;
+	if (options.max_seconds && iteration % 64 == 0)
+		return std::chrono::duration<double>(std::chrono::steady_clock::now()
+			- start_time).count() >= options.max_seconds;
+	return false;
+}
+
+} // namespace solvers
+} // namespace graphcoloring
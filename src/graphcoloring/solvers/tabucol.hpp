@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_SOLVERS_TABUCOL_H_
+#define GRAPHCOLORING_SOLVERS_TABUCOL_H_
+
+#include <chrono>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "adjacency.hpp"
+
+namespace graphcoloring {
+namespace solvers {
+
+// Anytime local search coloring (Hertz and de Werra's TabuCol). With k colors,
+// each iteration recolors one conflicting vertex, taking the best move which
+// isn't tabu (or is tabu but reaches a new best: the aspiration criterion).
+// A conflict matrix makes each move O(degree). Whenever there are no
+// conflicts, k is lowered, until it reaches the clique bound (or the largest
+// fixed color + 1) or the budget runs out. Long runs without improvement restart from a random coloring.
+// If a score function is given, k stays fixed and the search instead walks
+// between conflict-free colorings, keeping the one with the highest score.
+class TabuCol {
+public:
+	typedef std::function<int(const std::vector<int>&)> score_t; // Higher is better
+	struct Options
+	{
+		long long max_iterations = 0; // 0 = no limit
+		double max_seconds = 1; // 0 = no limit
+		int colors = 0; // Colors to start with; 0 = as many as DSATUR uses
+		bool dsatur_start = true; // Otherwise start from a random coloring
+		long long restart_iterations = 100000; // Without improvement
+		int tenure_base = 10; // Tabu tenure is random(tenure_base) + ...
+		double tenure_factor = 0.6; // ... tenure_factor * # of conflicting vertices
+		std::vector<int> fixed; // Color of each vertex which can't be recolored (-1 for the others)
+		score_t score; // Optional
+		unsigned seed = 0;
+	};
+	struct Sample // The search's progress, recorded whenever the best improves
+	{
+		double seconds;
+		long long iteration;
+		int colors;
+		int conflicts;
+		int score;
+	};
+	struct Result
+	{
+		std::vector<int> coloring; // Best coloring found
+		int colors = 0; // Number of colors used by coloring
+		int conflicts = 0; // Edges whose endpoints have the same color in coloring
+		int score = 0; // Only if there is a score function
+		long long iterations = 0;
+		double seconds = 0;
+		std::vector<Sample> history;
+	};
+	TabuCol(const Adjacency& adjacency);
+	virtual ~TabuCol() {}
+	Result Run(); // Default options
+	Result Run(const Options& options);
+private:
+	void SetColors(int k, const std::vector<int>& initial); // Rebuild the conflict matrix
+	void Randomize();
+	void Move(int v, int color);
+	bool IsFixed(int v) const;
+	bool Step(); // Returns false if no move is possible.
+	bool Perturb(); // Random move; returns false if every vertex is fixed.
+	void Record(int score = 0); // Current coloring is the best so far.
+	bool OutOfBudget() const;
+
+	const Adjacency& adjacency;
+	const int n;
+	Options options;
+	Result result;
+	std::mt19937 rng;
+	std::chrono::steady_clock::time_point start_time;
+	long long iteration;
+	int k; // Number of colors
+	std::vector<int> coloring;
+	std::vector<int> gamma; // [v * k + c] = # of neighbors of v with color c
+	std::vector<long long> tabu; // [v * k + c] = Iteration until which v can't get c back
+	int conflicts;
+	int best_conflicts; // Best since the last change to k (or restart)
+	long long last_improvement; // Iteration of the last improvement of best_conflicts
+};
+
+} // namespace solvers
+} // namespace graphcoloring
+
+#endif // GRAPHCOLORING_SOLVERS_TABUCOL_H_
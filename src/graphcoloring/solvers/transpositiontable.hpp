@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_SOLVERS_TRANSPOSITIONTABLE_H_
+#define GRAPHCOLORING_SOLVERS_TRANSPOSITIONTABLE_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace graphcoloring {
+namespace solvers {
+
+// Remembers what a search found for the graph states (see Graph::Hash) it
+// has already visited. It's a fixed-size table indexed by the low bits of
+// the hash, and a new entry replaces whatever was in its slot.
+template <typename Value>
+class TranspositionTable {
+public:
+	explicit TranspositionTable(int bits = 16)
+		: mask((uint64_t(1) << bits) - 1), entries(mask + 1) {}
+	bool Find(uint64_t hash, Value& value) const // Returns false if hash isn't in the table.
+	{
+		const Entry& entry = entries[hash & mask];
+		if (!entry.used || entry.hash != hash) return false;
+		value = entry.value;
+		return true;
+	}
+	void Store(uint64_t hash, const Value& value)
+	{
+		Entry& entry = entries[hash & mask];
+		entry.used = true;
+		entry.hash = hash;
+		entry.value = value;
+	}
+	void Clear()
+	{
+		for (Entry& entry : entries)
+			entry.used = false;
+	}
+private:
+	struct Entry
+	{
+		bool used = false;
+		uint64_t hash = 0;
+		Value value;
+	};
+	const uint64_t mask;
+	std::vector<Entry> entries;
+};
+
+} // namespace solvers
+} // namespace graphcoloring
+
+#endif // GRAPHCOLORING_SOLVERS_TRANSPOSITIONTABLE_H_
@@ -59,6 +59,11 @@ Button::Button(Window* window_, const std::string& text_,
 		int callback_id = window->SetMouseupCallback(callback(button), button);
 		mouseup_callback_ids.push_back(callback_id);
 	}
+	mousemotion_callback_id = window->SetMousemotionCallback(
+		[this](Window*,int,int) {
+			if (CheckHovering())
+				window->Invalidate(Bounds());
+		});
 }
 
 Button::~Button()
@@ -66,12 +71,14 @@ Button::~Button()
 	int i;
 	for (i = 0; i < (int)MOUSE_BUTTONS.size(); i++)
 		window->RemoveMouseupCallback(mouseup_callback_ids[i],MOUSE_BUTTONS[i]);
+	window->RemoveMousemotionCallback(mousemotion_callback_id);
 }
 
 
 
-void Button::CheckHovering()
+bool Button::CheckHovering()
 {
+	bool was_hovering = hovering;
 	int mx = window->GetMouseX(), my = window->GetMouseY();
 	hovering = shape == Shape::RECTANGLE
 		? utils::geometry::InRectangle(mx, my, GetX(), GetY(),
@@ -81,6 +88,7 @@ void Button::CheckHovering()
 	if (hovering)
 		for (callback_t callback : hover_callbacks)
 			callback();
+	return hovering != was_hovering;
 }
 
 void Button::CheckClick(guint button)
@@ -98,15 +106,9 @@ void Button::CheckClick(guint button)
 void Button::Render()
 {
 	CheckHovering();
-	window->SetLineWidth(BORDER_WIDTH);
-	window->SetDrawColor(colors::Shade(color, 0.3));
-	if (shape == Shape::CIRCLE)
-		window->SetTextSize(GetRadius()*CIRCLE_TEXT_SIZE_FACTOR);
-	else
-		window->SetTextSize(GetHeight()*TEXT_SIZE_FACTOR);
-
 	if (hovering)
 	{
+		window->SetDrawColor(colors::Shade(color, 0.3));
 		switch (shape)
 		{
 		case Shape::RECTANGLE:
@@ -119,6 +121,16 @@ void Button::Render()
 			break;
 		}
 	}
+	RenderStatic();
+}
+
+void Button::RenderStatic()
+{
+	window->SetLineWidth(BORDER_WIDTH);
+	if (shape == Shape::CIRCLE)
+		window->SetTextSize(GetRadius()*CIRCLE_TEXT_SIZE_FACTOR);
+	else
+		window->SetTextSize(GetHeight()*TEXT_SIZE_FACTOR);
 
 	window->SetDrawColor(color);
 	switch (shape)
@@ -166,6 +178,20 @@ int Button::GetWidth()  const { return size.X();  }
 int Button::GetHeight() const { return size.Y(); }
 int Button::GetRadius() const { return size.X(); }
 
+bool Button::IsHovering() const
+{
+	return hovering;
+}
+
+Rectangle Button::Bounds() const
+{
+	int diameter = 2 * GetRadius();
+	return (shape == Shape::CIRCLE
+		? Rectangle{GetX(), GetY(), diameter, diameter}
+		: Rectangle{GetX(), GetY(), GetWidth(), GetHeight()})
+		.Padded(BORDER_WIDTH);
+}
+
 int Button::GetX() const
 {
 	return position.AlignedX(horizontal_align, GetWidth());
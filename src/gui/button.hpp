@@ -50,16 +50,19 @@ public:
 	void SetCommand(callback_t callback, guint button = GDK_BUTTON_PRIMARY);
 	void SetHoverCallback(callback_t callback);
 	void Render();
+	void RenderStatic(); // Everything but the hover highlight
+	bool IsHovering() const;
 	int GetX() const;
 	int GetY() const;
 	int GetWidth() const;
 	int GetHeight() const;
 	int GetRadius() const;
+	Rectangle Bounds() const; // Area covered when rendered
 	void SetPosition(Position position);
 	void SetAlignment(Alignment horizontal_align, Alignment vertical_align);
 	static constexpr double CIRCLE_TEXT_SIZE_FACTOR = 0.9; // Allows for ~2 characters
 private:
-	void CheckHovering();
+	bool CheckHovering(); // Returns true if hovering changed.
 	void CheckClick(guint button);
 	static constexpr int BORDER_WIDTH = 3;
 	static constexpr double TEXT_SIZE_FACTOR = 0.7;
@@ -73,6 +76,7 @@ private:
 	Shape shape;
 	bool hovering;
 	std::vector<int> mouseup_callback_ids;
+	int mousemotion_callback_id;
 	callback_map_t callbacks;
 	std::vector<callback_t> hover_callbacks;
 };
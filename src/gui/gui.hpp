@@ -21,8 +21,12 @@
 
 #include "button.hpp"
 #include "colors.hpp"
+#include "layer.hpp"
 #include "menu.hpp"
+#include "offscreenwindow.hpp"
 #include "position.hpp"
+#include "rectangle.hpp"
+#include "viewport.hpp"
 #include "window.hpp"
 
 #endif // GRAPHCOLORING_GUI_GUI_H_
@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "layer.hpp"
+
+namespace gui {
+
+Layer::Layer(Window* window_, Window::callback_t render_)
+	: window(window_), render(render_)
+{
+}
+
+Layer::~Layer()
+{
+	if (surface != nullptr)
+		cairo_surface_destroy(surface);
+}
+
+void Layer::Invalidate()
+{
+	is_valid = false;
+	window->Invalidate();
+}
+
+void Layer::Render()
+{
+	int window_width = window->GetWidth(), window_height = window->GetHeight();
+	if (!is_valid || window_width != width || window_height != height)
+		Rasterize(window_width, window_height);
+	if (!window->IsDamaged(bounds))
+		return;
+	window->FlushBatch();
+	cairo_set_source_surface(window->cr, surface, 0, 0);
+	cairo_rectangle(window->cr, bounds.x, bounds.y, bounds.w, bounds.h);
+	cairo_fill(window->cr);
+	window->frame_stats.strokes++;
+}
+
+void Layer::Rasterize(int width_, int height_)
+{
+	if (surface == nullptr || width_ != width || height_ != height)
+	{
+		if (surface != nullptr)
+			cairo_surface_destroy(surface);
+		width = width_;
+		height = height_;
+		surface = cairo_surface_create_similar(cairo_get_target(window->cr),
+			CAIRO_CONTENT_COLOR_ALPHA, width, height);
+	}
+	cairo_t* cr = cairo_create(surface);
+	cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+	cairo_paint(cr);
+	cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+	// Point the window at the surface, with all of it damaged, while the
+	// content is drawn. Anything the window had queued goes first.
+	window->FlushBatch();
+	bool was_batching = window->is_batching;
+	window->is_batching = false;
+	cairo_t* window_cr = window->cr;
+	std::vector<Rectangle> window_damage;
+	window_damage.swap(window->damage);
+	window->cr = cr;
+	window->damage.push_back(Rectangle{0, 0, width, height});
+	bounds = Rectangle{0, 0, 0, 0};
+	window->drawn_bounds = &bounds;
+	render(window);
+	window->drawn_bounds = nullptr;
+	window->damage.swap(window_damage);
+	window->cr = window_cr;
+	window->is_batching = was_batching;
+
+	cairo_destroy(cr);
+	is_valid = true;
+	window->frame_stats.rasterized++;
+}
+
+} // namespace gui
@@ -0,0 +1,48 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_GUI_LAYER_H_
+#define GRAPHCOLORING_GUI_LAYER_H_
+
+#include "window.hpp"
+
+namespace gui {
+
+// Static content (e.g. text which never changes) which is drawn once onto its
+// own surface, and then just composited onto the window every frame. It is
+// only redrawn after Invalidate is called, or when the window is resized.
+class Layer
+{
+public:
+	Layer(Window* window, Window::callback_t render);
+	virtual ~Layer();
+	void Invalidate(); // The content has changed.
+	void Render();
+private:
+	void Rasterize(int width, int height);
+	Window* const window;
+	Window::callback_t render; // Draws the content, with the usual functions
+	cairo_surface_t* surface = nullptr;
+	int width = 0, height = 0; // Size of surface
+	Rectangle bounds{0, 0, 0, 0}; // Part of surface which has been drawn on
+	bool is_valid = false;
+};
+
+} // namespace gui
+
+#endif // GRAPHCOLORING_GUI_LAYER_H_
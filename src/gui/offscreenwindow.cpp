@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "offscreenwindow.hpp"
+
+#include <chrono>
+
+namespace gui {
+
+OffscreenWindow::OffscreenWindow(int width, int height)
+	: Window(width, height)
+{
+	LoadFont();
+	surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+	// Text can be measured outside of frames, so cr always exists.
+	cr = cairo_create(surface);
+}
+
+OffscreenWindow::~OffscreenWindow()
+{
+	cairo_destroy(cr);
+	cairo_surface_destroy(surface);
+}
+
+double OffscreenWindow::RenderFrame()
+{
+	auto start = std::chrono::steady_clock::now();
+	cairo_save(cr);
+	Render();
+	cairo_restore(cr);
+	cairo_surface_flush(surface);
+	return std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+}
+
+bool OffscreenWindow::WritePNG(const std::string& filename) const
+{
+	return cairo_surface_write_to_png(surface, filename.c_str())
+		== CAIRO_STATUS_SUCCESS;
+}
+
+} // namespace gui
@@ -0,0 +1,43 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_GUI_OFFSCREENWINDOW_H_
+#define GRAPHCOLORING_GUI_OFFSCREENWINDOW_H_
+
+#include <string>
+
+#include "window.hpp"
+
+namespace gui {
+
+// A Window which is never shown. Frames are drawn onto an image in memory
+// when asked for, so rendering can be timed or saved without a display or a
+// GtkApplication. No input events are ever delivered to it.
+class OffscreenWindow : public Window {
+public:
+	OffscreenWindow(int width, int height);
+	virtual ~OffscreenWindow();
+	double RenderFrame(); // Draws a whole frame. Returns how long it took, in seconds.
+	bool WritePNG(const std::string& filename) const; // Returns false on failure
+private:
+	cairo_surface_t* surface;
+};
+
+} // namespace gui
+
+#endif // GRAPHCOLORING_GUI_OFFSCREENWINDOW_H_
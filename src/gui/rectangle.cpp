@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "rectangle.hpp"
+
+#include <algorithm>
+
+namespace gui {
+
+bool Rectangle::IsEmpty() const
+{
+	return w <= 0 || h <= 0;
+}
+
+bool Rectangle::Intersects(const Rectangle& other) const
+{
+	return !IsEmpty() && !other.IsEmpty()
+		&& x < other.x + other.w && other.x < x + w
+		&& y < other.y + other.h && other.y < y + h;
+}
+
+Rectangle Rectangle::Padded(int padding) const
+{
+	return Rectangle{x - padding, y - padding, w + 2*padding, h + 2*padding};
+}
+
+Rectangle Rectangle::Union(const Rectangle& other) const
+{
+	if (IsEmpty()) return other;
+	if (other.IsEmpty()) return *this;
+	return Around(std::min(x, other.x), std::min(y, other.y),
+		std::max(x + w, other.x + other.w) - 1,
+		std::max(y + h, other.y + other.h) - 1);
+}
+
+Rectangle Rectangle::Around(int x1, int y1, int x2, int y2)
+{
+	int left = std::min(x1, x2), top = std::min(y1, y2);
+	return Rectangle{left, top,
+		std::max(x1, x2) - left + 1, std::max(y1, y2) - top + 1};
+}
+
+} // namespace gui
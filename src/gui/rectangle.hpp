@@ -0,0 +1,37 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_GUI_RECTANGLE_H_
+#define GRAPHCOLORING_GUI_RECTANGLE_H_
+
+namespace gui {
+
+// An axis-aligned rectangle of pixels, in window coordinates.
+struct Rectangle
+{
+	int x, y, w, h;
+	bool IsEmpty() const;
+	bool Intersects(const Rectangle& other) const;
+	Rectangle Padded(int padding) const; // Grows each side by padding
+	Rectangle Union(const Rectangle& other) const; // Smallest rectangle containing both
+	static Rectangle Around(int x1, int y1, int x2, int y2); // Smallest rectangle containing both points
+};
+
+} // namespace gui
+
+#endif // GRAPHCOLORING_GUI_RECTANGLE_H_
@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "viewport.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace gui {
+
+constexpr double Viewport::MIN_ZOOM;
+constexpr double Viewport::MAX_ZOOM;
+
+Viewport::Viewport(int x_, int y_, double zoom_)
+	: Position(x_, y_)
+{
+	SetZoom(zoom_);
+}
+
+double Viewport::Zoom() const
+{
+	return zoom;
+}
+
+void Viewport::SetZoom(double zoom_)
+{
+	zoom = std::min(std::max(zoom_, MIN_ZOOM), MAX_ZOOM);
+}
+
+void Viewport::ZoomAround(double zoom_, int screen_x, int screen_y)
+{
+	int world_x = WorldX(screen_x);
+	int world_y = WorldY(screen_y);
+	SetZoom(zoom_);
+	SetPos(world_x - (int)std::floor(screen_x / zoom),
+		world_y - (int)std::floor(screen_y / zoom));
+}
+
+int Viewport::ScreenX(double world_x) const
+{
+	return (int)std::floor((world_x - X()) * zoom);
+}
+
+int Viewport::ScreenY(double world_y) const
+{
+	return (int)std::floor((world_y - Y()) * zoom);
+}
+
+int Viewport::WorldX(int screen_x) const
+{
+	return X() + (int)std::floor(screen_x / zoom);
+}
+
+int Viewport::WorldY(int screen_y) const
+{
+	return Y() + (int)std::floor(screen_y / zoom);
+}
+
+int Viewport::ScreenLength(int world_length) const
+{
+	return (int)std::round(world_length * zoom);
+}
+
+} // namespace gui
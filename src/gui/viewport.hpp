@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_GUI_VIEWPORT_H_
+#define GRAPHCOLORING_GUI_VIEWPORT_H_
+
+#include "position.hpp"
+
+namespace gui {
+
+// Which part of the plane is shown in the window. The position is the point
+// shown at the top-left corner, and the zoom is how many pixels one unit of
+// the plane takes up.
+class Viewport : public Position {
+public:
+	Viewport(int x = 0, int y = 0, double zoom = 1);
+	double Zoom() const;
+	void SetZoom(double zoom); // Clamped between MIN_ZOOM and MAX_ZOOM
+	// Zooms while keeping the point at (screen_x, screen_y) where it is.
+	void ZoomAround(double zoom, int screen_x, int screen_y);
+	int ScreenX(double world_x) const;
+	int ScreenY(double world_y) const;
+	int WorldX(int screen_x) const;
+	int WorldY(int screen_y) const;
+	int ScreenLength(int world_length) const;
+	static constexpr double MIN_ZOOM = 1.0 / 64;
+	static constexpr double MAX_ZOOM = 4;
+private:
+	double zoom;
+};
+
+} // namespace gui
+
+#endif // GRAPHCOLORING_GUI_VIEWPORT_H_
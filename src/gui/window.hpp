@@ -23,11 +23,15 @@
 #include <functional>
 #include <vector>
 #include <map>
+#include <string>
 
 #include <gtk/gtk.h>
 
+#include "utils/lrucache.hpp"
+
 #include "colors.hpp"
 #include "position.hpp"
+#include "rectangle.hpp"
 
 namespace gui {
 
@@ -41,7 +45,24 @@ public:
 	typedef std::map<guint, std::vector<mouse_callback_t>> mouse_callback_map_t;
 	typedef std::function<void(Window*,GdkScrollDirection)> scroll_callback_t;
 
+    struct FrameStats
+    {
+        int drawn = 0; // Primitives which touched the damaged area
+        int culled = 0; // Primitives skipped because they were outside it
+        int rasterized = 0; // Layers which had to be redrawn
+        int text_hits = 0; // Text drawn or measured from the text cache
+        int text_misses = 0;
+        int strokes = 0; // cairo strokes and fills
+    };
+    static bool print_frame_stats; // Print FrameStats after every frame?
+    // Shows or hides timings from utils::profiler and per frame counters over
+    // the top of the window, enabling the profiler the first time.
+    static constexpr guint PROFILER_KEY = GDK_KEY_F3;
+
     Window(const char* title, int width, int height, int fps = 30);
+    // A window which is never opened, without a GtkApplication, for graphs
+    // which are never shown (e.g. in the solvers). Nothing can be drawn on it.
+    Window(int width, int height);
     virtual ~Window();
     // window_main.cpp methods
     int GetWidth() const;
@@ -55,6 +76,22 @@ public:
     // window_rendering.cpp methods
     int SetRenderCallback(callback_t callback);
     void RemoveRenderCallback(int id);
+    // The window is only redrawn when something has changed. Keyboard,
+    // scroll and non-primary button events invalidate it automatically;
+    // anything else which changes what's drawn (including animations, from
+    // inside render callbacks) should call one of these. Only the damaged
+    // area is repainted, and primitives outside of it are skipped.
+    void Invalidate();
+    void Invalidate(const Rectangle& area);
+    const FrameStats& LastFrameStats() const;
+    void SetContinuous(bool continuous); // Redraw every frame (at most FPS times a second), e.g. while a key is held.
+    bool IsContinuous() const;
+    // Between BeginBatch and EndBatch, lines, rectangles and circles are
+    // queued up, then drawn with one cairo path for each color, line width
+    // and fill, in the order each of those was first used. Text, images and
+    // polygons draw everything queued before them first, so they stay on top.
+    void BeginBatch();
+    void EndBatch();
     void SetDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
     void SetDrawColor(Color color); // Sets color to value. Format: 0xRRGGBBAA.
     void SetLineWidth(int line_width);
@@ -102,6 +139,9 @@ public:
     int GetMouseY() const;
 
 private:
+    friend class Layer;
+    friend class OffscreenWindow;
+
     // window_main.cpp methods
     void InitializeWindow();
     void InitializeApplication(const char* title);
@@ -139,20 +179,78 @@ private:
 
     // window_rendering.cpp methods
     friend void GtkDrawCallback(GtkWidget*, cairo_t*, gpointer);
+    friend gboolean QueueDraw(gpointer);
     void InitializeDrawingArea();
+    void LoadFont();
     void Render();
     cairo_surface_t* GetSurface(const std::string& filename);
+    bool IsDamaged(const Rectangle& bounds); // Should something here be drawn?
+    int LinePadding() const;
+    // Primitives are built out of these, so they can be queued while batching.
+    void BeginPath(bool filled);
+    void MoveTo(double x, double y);
+    void LineTo(double x, double y);
+    void Arc(double x, double y, double r, double angle1, double angle2);
+    void ClosePath();
+    void EndPath();
+    void FlushBatch(); // Draws everything queued so far
+    struct TextLayout
+    {
+        cairo_text_extents_t extents;
+        std::vector<cairo_glyph_t> glyphs; // Relative to the text's origin
+    };
+    const TextLayout& LayOutText(const std::string& text); // Also selects the font
+    void DrawTextLayout(const TextLayout& layout, int x, int y);
+    void RenderProfiler();
 
     // window_main.cpp members
     Size size;
     const char* title;
     const int FPS;
-    GtkApplication* application;
-    GtkWidget* window;
+    GtkApplication* application = nullptr;
+    GtkWidget* window = nullptr; // nullptr until the window is opened
     std::function<void()> on_activate;
 
     // window_rendering.cpp members
-    cairo_t* cr;
+    GtkWidget* drawing_area = nullptr; // nullptr until the window is opened
+    bool is_continuous = false;
+    guint redraw_timeout = 0; // 0 unless the window is open and continuous
+    cairo_t* cr = nullptr;
+    std::vector<Rectangle> damage; // Area being repainted this frame
+    FrameStats frame_stats, last_frame_stats;
+    bool is_profiler_shown = false;
+    Rectangle* drawn_bounds = nullptr; // If set, grown to cover whatever is drawn
+    Color draw_color = colors::BLACK;
+    struct PathOp
+    {
+        enum class Type { MOVE_TO, LINE_TO, ARC, CLOSE_PATH } type;
+        double x, y, r, angle1, angle2;
+    };
+    struct BatchGroup
+    {
+        Color color;
+        double line_width;
+        bool filled;
+        std::vector<PathOp> path;
+    };
+    bool is_batching = false;
+    std::vector<BatchGroup> batch; // In the order they were first used
+    BatchGroup* path_group = nullptr; // Where the path being built goes, if batching
+    bool is_path_filled = false;
+    struct TextKey
+    {
+        std::string text;
+        double size;
+        cairo_font_face_t* font;
+        bool operator==(const TextKey& other) const;
+    };
+    struct TextKeyHash
+    {
+        size_t operator()(const TextKey& key) const;
+    };
+    static constexpr size_t TEXT_CACHE_SIZE = 512;
+    utils::LRUCache<TextKey, TextLayout, TextKeyHash> text_cache;
+    double text_size = 10; // cairo's default
     cairo_font_face_t* font;
     std::map<std::string, cairo_surface_t*> images; // Only load each image once.
     std::vector<callback_t> render_callbacks;
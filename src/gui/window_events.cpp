@@ -88,6 +88,7 @@ template void Window::RemoveFromCallbackList<Window::callback_t>(
 template void Window::RemoveFromCallbackList<Window::scroll_callback_t>(
 	std::vector<scroll_callback_t>&, int);
 
+#ifndef HEADLESS
 void Window::InitializeEvents()
 {
 	gtk_widget_set_events(window, GDK_POINTER_MOTION_MASK | GDK_SCROLL_MASK
@@ -108,5 +109,6 @@ void Window::InitializeEvents()
     g_signal_connect(G_OBJECT(window), "scroll-event",
     	G_CALLBACK(GtkScrollCallback), this);
 }
+#endif
 
 } // namespace gui
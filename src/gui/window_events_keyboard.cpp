@@ -19,6 +19,7 @@
 #include "window.hpp"
 
 #include "utils/errors.hpp"
+#include "utils/profiler.hpp"
 
 namespace gui {
 
@@ -39,6 +40,11 @@ void Window::RemoveKeydownCallback(int id, guint key)
 void Window::ProcessKeydown(GdkEventKey* event)
 {
 	keymap[event->keyval] = true;
+	if (event->keyval == PROFILER_KEY)
+	{
+		is_profiler_shown = !is_profiler_shown;
+		utils::profiler::Enable();
+	}
 	is_keydown_callbacks_modified = false;
 	for (callback_t callback
 		: CheckCallbackMap<callback_t>(keydown_callbacks, event->keyval))
@@ -48,6 +54,7 @@ void Window::ProcessKeydown(GdkEventKey* event)
 		if (is_keydown_callbacks_modified)
 			break;
 	}
+	Invalidate();
 }
 
 void GtkKeydownCallback(GtkWidget*, GdkEventKey* event, gpointer data)
@@ -82,6 +89,7 @@ void Window::ProcessKeyup(GdkEventKey* event)
 		if (is_keyup_callbacks_modified)
 			break;
 	}
+	Invalidate();
 }
 
 void GtkKeyupCallback(GtkWidget*, GdkEventKey* event, gpointer data)
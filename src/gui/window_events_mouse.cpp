@@ -43,6 +43,9 @@ void Window::ProcessMousedown(GdkEventButton* event)
 		if (is_mousedown_callbacks_modified)
 			break;
 	}
+	// Whatever primary clicks change invalidates its own area.
+	if (event->button != GDK_BUTTON_PRIMARY)
+		Invalidate();
 }
 
 int Window::SetMousedownCallback(mouse_callback_t callback, guint button)
@@ -76,7 +79,8 @@ void Window::ProcessMouseup(GdkEventButton* event)
 		if (is_mouseup_callbacks_modified)
 			break;
 	}
-
+	if (event->button != GDK_BUTTON_PRIMARY)
+		Invalidate();
 }
 
 int Window::SetMouseupCallback(mouse_callback_t callback, guint button)
@@ -142,6 +146,7 @@ void Window::ProcessScroll(GdkEventScroll* event)
 		if (is_scroll_callbacks_modified)
 			break;
 	}
+	Invalidate();
 }
 
 int Window::SetScrollCallback(scroll_callback_t callback)
@@ -23,6 +23,7 @@
 
 namespace gui {
 
+#ifndef HEADLESS
 void Window::InitializeWindow()
 {
     // Initialize the Gtk Window
@@ -36,6 +37,7 @@ void Window::InitializeWindow()
     gtk_widget_show_all(window);
     on_activate();
 }
+#endif
 
 void Window::OnActivate(std::function<void()> callback)
 {
@@ -54,6 +56,7 @@ void Window::RemoveAllCallbacks()
 	render_callbacks.erase(render_callbacks.begin(), render_callbacks.end());
 }
 
+#ifndef HEADLESS
 void Activate(GtkApplication*, gpointer data)
 {
     // This will be called when the application activates.
@@ -61,22 +64,36 @@ void Activate(GtkApplication*, gpointer data)
     Window* win = (Window*)data;
     win->InitializeWindow();
 }
+#endif
 
 void Window::InitializeApplication(const char* t)
 {
     title = t;
+#ifdef HEADLESS
+    utils::errors::Die("Built without GTK, so windows can't be opened.");
+#else
     application = gtk_application_new("com.pommicket.graphcoloring",
                                       G_APPLICATION_FLAGS_NONE);
     g_signal_connect(application, "activate", G_CALLBACK(&Activate), this);
+#endif
 }
 
 Window::Window(const char* title, int w, int h, int fps)
-    : size(w,h), FPS(fps)
+    : size(w,h), FPS(fps), text_cache(TEXT_CACHE_SIZE)
 {
     InitializeApplication(title);
 }
 
-Window::~Window() {}
+Window::Window(int w, int h)
+    : size(w,h), title(""), FPS(0), text_cache(TEXT_CACHE_SIZE)
+{
+}
+
+Window::~Window()
+{
+    if (application != nullptr)
+        g_object_unref(application);
+}
 
 int Window::GetWidth()  const { return size.X();  }
 int Window::GetHeight() const { return size.Y(); }
@@ -90,13 +107,19 @@ Position Window::GetPosition(int x, int y, double xrel, double yrel)
 
 void Window::Quit()
 {
+	if (application == nullptr) return;
+#ifndef HEADLESS
 	g_application_quit(G_APPLICATION(application));
+#endif
 }
 
 void Window::Mainloop()
 {
+#ifndef HEADLESS
     g_application_run(G_APPLICATION(application), 0, NULL);
     g_object_unref(application);
+    application = nullptr;
+#endif
 }
 
 } // namespace gui
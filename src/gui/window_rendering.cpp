@@ -17,17 +17,22 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #define _USE_MATH_DEFINES
+#include <algorithm>
 #include <cmath>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <cairo/cairo-ft.h>
 #include <freetype2/ft2build.h>
 #include FT_FREETYPE_H
 
 #include "utils/errors.hpp"
+#include "utils/profiler.hpp"
 #include "window.hpp"
 
 namespace gui {
 
+bool Window::print_frame_stats = false;
 
 void GtkDrawCallback(GtkWidget* widget, cairo_t* c, gpointer data)
 {
@@ -38,22 +43,28 @@ void GtkDrawCallback(GtkWidget* widget, cairo_t* c, gpointer data)
 
 gboolean QueueDraw(gpointer w)
 {
-	GtkWidget* window = (GtkWidget*) w;
-	gtk_widget_queue_draw(window);
-    return TRUE;
+	Window* win = (Window*) w;
+	win->Invalidate();
+	return TRUE;
 }
 
+#ifndef HEADLESS
 void Window::InitializeDrawingArea()
 {
-    GtkWidget* drawing_area = gtk_drawing_area_new ();
+    drawing_area = gtk_drawing_area_new ();
     gtk_widget_set_size_request (drawing_area, 100, 100);
     g_signal_connect(G_OBJECT(drawing_area), "draw",
                      G_CALLBACK(&GtkDrawCallback), this);
-    g_timeout_add(1000/FPS, QueueDraw, drawing_area);
+    if (is_continuous) // SetContinuous was called before the window opened.
+    	redraw_timeout = g_timeout_add(1000/FPS, QueueDraw, this);
 
     gtk_container_add(GTK_CONTAINER(window), drawing_area);
+    LoadFont();
+}
+#endif
 
-    // Also initialize font
+void Window::LoadFont()
+{
     FT_Library library;
     FT_Face font_face;
     if (FT_Init_FreeType(&library))
@@ -76,6 +87,7 @@ int Window::SetRenderCallback(callback_t callback)
 {
     render_callbacks.push_back(callback);
 	is_render_callbacks_modified = true;
+	Invalidate();
     return render_callbacks.size()-1;
 }
 
@@ -83,30 +95,313 @@ void Window::RemoveRenderCallback(int id)
 {
 	RemoveFromCallbackList(render_callbacks, id);
 	is_render_callbacks_modified = true;
+	Invalidate();
+}
+
+// Without GTK, there's never a drawing area to queue a draw on.
+void Window::Invalidate()
+{
+#ifndef HEADLESS
+	if (drawing_area)
+		gtk_widget_queue_draw(drawing_area);
+#endif
+}
+
+void Window::Invalidate(const Rectangle& area)
+{
+#ifndef HEADLESS
+	if (drawing_area && !area.IsEmpty())
+		gtk_widget_queue_draw_area(drawing_area, area.x, area.y, area.w,
+			area.h);
+#endif
+}
+
+const Window::FrameStats& Window::LastFrameStats() const
+{
+	return last_frame_stats;
+}
+
+void Window::SetContinuous(bool continuous)
+{
+	if (continuous == is_continuous) return;
+	is_continuous = continuous;
+	if (!drawing_area) return;
+	if (continuous)
+	{
+		redraw_timeout = g_timeout_add(1000/FPS, QueueDraw, this);
+	}
+	else
+	{
+		g_source_remove(redraw_timeout);
+		redraw_timeout = 0;
+	}
+}
+
+bool Window::IsContinuous() const
+{
+	return is_continuous;
 }
 
 void Window::Render()
 {
-	int width, height;
-	gtk_window_get_size(GTK_WINDOW(window), &width, &height);
-	size.SetPos(width, height);
-	is_render_callbacks_modified = false;
-    for (callback_t callback : render_callbacks)
+#ifndef HEADLESS
+	if (window != nullptr) // Offscreen windows keep their size.
+	{
+		int width, height;
+		gtk_window_get_size(GTK_WINDOW(window), &width, &height);
+		size.SetPos(width, height);
+	}
+#endif
+	int width = GetWidth(), height = GetHeight();
+
+	// GTK has already clipped cr to the invalidated areas. Read them back so
+	// that primitives outside of them can be skipped altogether.
+	damage.clear();
+	cairo_rectangle_list_t* clip = cairo_copy_clip_rectangle_list(cr);
+	if (clip->status == CAIRO_STATUS_SUCCESS)
+	{
+		for (int i = 0; i < clip->num_rectangles; i++)
+		{
+			const cairo_rectangle_t& r = clip->rectangles[i];
+			damage.push_back(Rectangle{(int)std::floor(r.x),
+				(int)std::floor(r.y), (int)std::ceil(r.width) + 1,
+				(int)std::ceil(r.height) + 1});
+		}
+	}
+	else // Not representable as rectangles; repaint everything.
+	{
+		damage.push_back(Rectangle{0, 0, width, height});
+	}
+	cairo_rectangle_list_destroy(clip);
+	frame_stats = FrameStats();
+
+	{
+		utils::profiler::ScopedTimer timer("Window::Render");
+		is_render_callbacks_modified = false;
+		for (callback_t callback : render_callbacks)
+		{
+			if (!callback) continue;
+			callback(this);
+			// If a callback modifies the list of render callbacks, give up on
+			// trying to read the whole list.
+			if (is_render_callbacks_modified)
+				break;
+		}
+	}
+	if (is_batching)
+		utils::errors::Die("Batch was not ended before the end of the frame.");
+	last_frame_stats = frame_stats;
+	utils::profiler::RecordCount("drawn", frame_stats.drawn);
+	utils::profiler::RecordCount("culled", frame_stats.culled);
+	utils::profiler::RecordCount("layers rasterized", frame_stats.rasterized);
+	utils::profiler::RecordCount("text cache hits", frame_stats.text_hits);
+	utils::profiler::RecordCount("text cache misses", frame_stats.text_misses);
+	utils::profiler::RecordCount("strokes", frame_stats.strokes);
+	if (print_frame_stats)
+		std::cout << "Frame: " << frame_stats.drawn << " drawn, "
+			<< frame_stats.culled << " culled, " << frame_stats.rasterized
+			<< " layers rasterized, " << frame_stats.text_hits << "/"
+			<< frame_stats.text_hits + frame_stats.text_misses
+			<< " text cache hits, " << frame_stats.strokes << " strokes"
+			<< std::endl;
+	if (is_profiler_shown)
+		RenderProfiler();
+}
+
+void Window::RenderProfiler()
+{
+	constexpr int X = 10, Y = 10, WIDTH = 420, LINE_HEIGHT = 14;
+	constexpr int COLUMN_WIDTH = 60; // For min, avg and p99
+	std::vector<std::vector<std::string>> rows;
+	auto add_rows = [&rows](const std::string& title,
+		const std::vector<utils::profiler::Stats>& all)
+	{
+		rows.push_back({title, "min", "avg", "p99"});
+		for (const utils::profiler::Stats& stats : all)
+		{
+			std::vector<std::string> row{stats.name};
+			for (double value : {stats.min, stats.average, stats.p99})
+			{
+				std::ostringstream text;
+				text << std::fixed << std::setprecision(2) << value;
+				row.push_back(text.str());
+			}
+			rows.push_back(row);
+		}
+	};
+	add_rows("ms", utils::profiler::Sections());
+	add_rows("per frame", utils::profiler::Counters());
+
+	Rectangle bounds{X, Y, WIDTH, (int)rows.size() * LINE_HEIGHT + 10};
+	Color old_color = draw_color;
+	double old_text_size = text_size;
+	SetDrawColor(0x000000C0);
+	DrawRectangle(bounds.x, bounds.y, bounds.w, bounds.h);
+	SetDrawColor(colors::WHITE);
+	SetTextSize(LINE_HEIGHT - 2);
+	for (size_t i = 0; i < rows.size(); i++)
+	{
+		int y = Y + 5 + i * LINE_HEIGHT;
+		DrawText(rows[i][0], X + 5, y);
+		for (size_t column = 1; column < rows[i].size(); column++)
+			DrawText(rows[i][column],
+				Position(X + WIDTH - 5 - (3 - column) * COLUMN_WIDTH, y),
+				Alignment::RIGHT);
+	}
+	SetDrawColor(old_color);
+	text_size = old_text_size;
+	// The numbers change every frame.
+	Invalidate(bounds);
+}
+
+bool Window::IsDamaged(const Rectangle& bounds)
+{
+	for (const Rectangle& area : damage)
+	{
+		if (area.Intersects(bounds))
+		{
+			if (drawn_bounds != nullptr)
+				*drawn_bounds = drawn_bounds->Union(bounds);
+			frame_stats.drawn++;
+			return true;
+		}
+	}
+	frame_stats.culled++;
+	return false;
+}
+
+int Window::LinePadding() const
+{
+	return (int)std::ceil(cairo_get_line_width(cr) / 2) + 1;
+}
+
+
+
+void Window::BeginBatch()
+{
+    if (is_batching)
+        utils::errors::Die("Batches can't be nested.");
+    is_batching = true;
+}
+
+void Window::EndBatch()
+{
+    FlushBatch();
+    is_batching = false;
+}
+
+void Window::BeginPath(bool filled)
+{
+    is_path_filled = filled;
+    path_group = nullptr;
+    if (!is_batching) return;
+    double line_width = cairo_get_line_width(cr);
+    for (BatchGroup& group : batch)
     {
-    	if (!callback) continue;
-    	callback(this);
-    	// If a callback modifies the list of render callbacks, give up on
-    	// trying to read the whole list.
-        if (is_render_callbacks_modified)
-        	break;
+        if (group.color == draw_color && group.line_width == line_width
+         && group.filled == filled)
+        {
+            path_group = &group;
+            return;
+        }
     }
+    batch.push_back(BatchGroup{draw_color, line_width, filled, {}});
+    path_group = &batch.back();
 }
 
+void Window::MoveTo(double x, double y)
+{
+    if (path_group != nullptr)
+        path_group->path.push_back(
+            PathOp{PathOp::Type::MOVE_TO, x, y, 0, 0, 0});
+    else
+        cairo_move_to(cr, x, y);
+}
+
+void Window::LineTo(double x, double y)
+{
+    if (path_group != nullptr)
+        path_group->path.push_back(
+            PathOp{PathOp::Type::LINE_TO, x, y, 0, 0, 0});
+    else
+        cairo_line_to(cr, x, y);
+}
+
+void Window::Arc(double x, double y, double r, double angle1, double angle2)
+{
+    if (path_group != nullptr)
+        path_group->path.push_back(
+            PathOp{PathOp::Type::ARC, x, y, r, angle1, angle2});
+    else
+        cairo_arc(cr, x, y, r, angle1, angle2);
+}
+
+void Window::ClosePath()
+{
+    if (path_group != nullptr)
+        path_group->path.push_back(
+            PathOp{PathOp::Type::CLOSE_PATH, 0, 0, 0, 0, 0});
+    else
+        cairo_close_path(cr);
+}
 
+void Window::EndPath()
+{
+    if (path_group != nullptr)
+    {
+        path_group = nullptr;
+        return;
+    }
+    if (is_path_filled)
+        cairo_fill(cr);
+    else
+        cairo_stroke(cr);
+    frame_stats.strokes++;
+}
 
+void Window::FlushBatch()
+{
+    if (batch.empty()) return;
+    Color color = draw_color;
+    double line_width = cairo_get_line_width(cr);
+    for (const BatchGroup& group : batch)
+    {
+        SetDrawColor(group.color);
+        cairo_set_line_width(cr, group.line_width);
+        for (const PathOp& op : group.path)
+        {
+            switch (op.type)
+            {
+            case PathOp::Type::MOVE_TO:
+                cairo_move_to(cr, op.x, op.y);
+                break;
+            case PathOp::Type::LINE_TO:
+                cairo_line_to(cr, op.x, op.y);
+                break;
+            case PathOp::Type::ARC:
+                // Don't join the arc to whatever came before it.
+                cairo_new_sub_path(cr);
+                cairo_arc(cr, op.x, op.y, op.r, op.angle1, op.angle2);
+                break;
+            case PathOp::Type::CLOSE_PATH:
+                cairo_close_path(cr);
+                break;
+            }
+        }
+        if (group.filled)
+            cairo_fill(cr);
+        else
+            cairo_stroke(cr);
+        frame_stats.strokes++;
+    }
+    batch.clear();
+    SetDrawColor(color);
+    cairo_set_line_width(cr, line_width);
+}
 
 void Window::SetDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
 {
+    draw_color = colors::Pack(r, g, b, a);
     cairo_set_source_rgba(cr,
         (double)r/255, (double)g/255, (double)b/255, (double)a/255);
 }
@@ -130,11 +425,15 @@ void Window::Clear()
 
 void Window::DrawRectangle(int x, int y, int w, int h, bool filled)
 {
-    cairo_rectangle(cr, x, y, w, h);
-    if (filled)
-        cairo_fill(cr);
-    else
-        cairo_stroke(cr);
+    if (!IsDamaged(Rectangle{x, y, w, h}.Padded(filled ? 1 : LinePadding())))
+        return;
+    BeginPath(filled);
+    MoveTo(x, y);
+    LineTo(x + w, y);
+    LineTo(x + w, y + h);
+    LineTo(x, y + h);
+    ClosePath();
+    EndPath();
 }
 
 void Window::DrawPoint(int x, int y)
@@ -144,19 +443,24 @@ void Window::DrawPoint(int x, int y)
 
 void Window::DrawLine(int x1, int y1, int x2, int y2)
 {
-    cairo_move_to(cr, x1, y1);
-    cairo_line_to(cr, x2, y2);
-    cairo_stroke(cr);
+    if (!IsDamaged(Rectangle::Around(x1, y1, x2, y2).Padded(LinePadding())))
+        return;
+    BeginPath(false);
+    MoveTo(x1, y1);
+    LineTo(x2, y2);
+    EndPath();
 }
 
 void Window::DrawArc(int x, int y, int r, double startAngle, double endAngle,
     bool filled)
 {
-    cairo_arc(cr, x, y, r, startAngle, endAngle);
-    if (filled)
-        cairo_fill(cr);
-    else
-        cairo_stroke(cr);
+    // Use the whole circle's bounds; arcs are rarely partial.
+    if (!IsDamaged(Rectangle::Around(x-r, y-r, x+r, y+r)
+    		.Padded(filled ? 1 : LinePadding())))
+        return;
+    BeginPath(filled);
+    Arc(x, y, r, startAngle, endAngle);
+    EndPath();
 }
 
 void Window::DrawCircle(int x, int y, int r, bool filled)
@@ -168,6 +472,20 @@ void Window::DrawPolygon(std::vector<std::pair<int,int>> points, bool filled)
 {
     if (points.size() < 2)
         utils::errors::Die("Trying to create polygon with less than 2 points.");
+    int min_x = points[0].first, max_x = min_x;
+    int min_y = points[0].second, max_y = min_y;
+    for (const std::pair<int,int>& point : points)
+    {
+        min_x = std::min(min_x, point.first);
+        max_x = std::max(max_x, point.first);
+        min_y = std::min(min_y, point.second);
+        max_y = std::max(max_y, point.second);
+    }
+    if (!IsDamaged(Rectangle::Around(min_x, min_y, max_x, max_y)
+            .Padded(filled ? 1 : LinePadding())))
+        return;
+    // Overlapping polygons could cancel each other out in one path.
+    FlushBatch();
     cairo_move_to(cr, points[0].first, points[0].second);
     for (unsigned i = 1; i < points.size(); i++)
         cairo_line_to(cr, points[i].first, points[i].second);
@@ -175,26 +493,82 @@ void Window::DrawPolygon(std::vector<std::pair<int,int>> points, bool filled)
         cairo_fill(cr);
     else
         cairo_stroke(cr);
+    frame_stats.strokes++;
 }
 
 void Window::SetTextSize(int size)
 {
-	cairo_set_font_size(cr, size);
+	text_size = size;
 }
 
-void Window::DrawText(const std::string& text, int x, int y)
+bool Window::TextKey::operator==(const TextKey& other) const
+{
+	return size == other.size && font == other.font && text == other.text;
+}
+
+size_t Window::TextKeyHash::operator()(const TextKey& key) const
+{
+	size_t hash = std::hash<std::string>()(key.text);
+	hash = hash * 31 + std::hash<double>()(key.size);
+	return hash * 31 + std::hash<cairo_font_face_t*>()(key.font);
+}
+
+const Window::TextLayout& Window::LayOutText(const std::string& text)
 {
+	// The font is selected every time, since layers draw with their own cr.
 	cairo_set_font_face(cr, font);
-	cairo_move_to(cr, x, y);
-	cairo_show_text(cr, text.c_str());
-	cairo_stroke(cr);
+	cairo_set_font_size(cr, text_size);
+	TextKey key{text, text_size, font};
+	const TextLayout* cached = text_cache.Find(key);
+	if (cached != nullptr)
+	{
+		frame_stats.text_hits++;
+		return *cached;
+	}
+	frame_stats.text_misses++;
+
+	TextLayout layout;
+	cairo_scaled_font_t* scaled_font = cairo_get_scaled_font(cr);
+	cairo_glyph_t* glyphs = nullptr;
+	int number_of_glyphs = 0;
+	if (cairo_scaled_font_text_to_glyphs(scaled_font, 0, 0, text.c_str(),
+			text.size(), &glyphs, &number_of_glyphs, nullptr, nullptr,
+			nullptr) == CAIRO_STATUS_SUCCESS)
+	{
+		layout.glyphs.assign(glyphs, glyphs + number_of_glyphs);
+		cairo_glyph_free(glyphs);
+	}
+	cairo_scaled_font_glyph_extents(scaled_font, layout.glyphs.data(),
+		layout.glyphs.size(), &layout.extents);
+	text_cache.Insert(key, layout);
+	return *text_cache.Find(key);
+}
+
+void Window::DrawTextLayout(const TextLayout& layout, int x, int y)
+{
+	const cairo_text_extents_t& extents = layout.extents;
+	Rectangle bounds{x + (int)std::floor(extents.x_bearing),
+		y + (int)std::floor(extents.y_bearing),
+		(int)std::ceil(extents.width) + 1, (int)std::ceil(extents.height) + 1};
+	if (!IsDamaged(bounds.Padded(1)))
+		return;
+	FlushBatch();
+	cairo_save(cr);
+	cairo_translate(cr, x, y);
+	cairo_show_glyphs(cr, layout.glyphs.data(), layout.glyphs.size());
+	cairo_restore(cr);
+}
+
+void Window::DrawText(const std::string& text, int x, int y)
+{
+	DrawTextLayout(LayOutText(text), x, y);
 }
 
 void Window::DrawText(const std::string& text, Position pos,
 		Alignment horizontal_align, Alignment vertical_align)
 {
-	int w, h, x, y;
-	GetTextSize(text, &w, &h);
+	const TextLayout& layout = LayOutText(text);
+	int w = layout.extents.width, h = layout.extents.height, x, y;
 	x = pos.X();
 	y = pos.Y();
 	switch (horizontal_align)
@@ -219,7 +593,7 @@ void Window::DrawText(const std::string& text, Position pos,
 	case Alignment::BOTTOM:
 		break;
 	}
-	DrawText(text, x, y);
+	DrawTextLayout(layout, x, y);
 }
 
 cairo_surface_t* Window::GetSurface(const std::string& filename)
@@ -244,6 +618,10 @@ cairo_surface_t* Window::GetSurface(const std::string& filename)
 void Window::DrawImage(const std::string& filename, int x, int y)
 {
 	cairo_surface_t* image = GetSurface(filename);
+	if (!IsDamaged(Rectangle{x, y, cairo_image_surface_get_width(image),
+			cairo_image_surface_get_height(image)}))
+		return;
+	FlushBatch();
 	cairo_set_source_surface(cr, image, x, y);
 	cairo_paint(cr);
 }
@@ -268,9 +646,7 @@ void Window::GetImageSize(const std::string& filename, int* w, int* h)
 
 void Window::GetTextSize(const std::string& text, int* w, int* h)
 {
-	cairo_set_font_face(cr, font);
-	cairo_text_extents_t extents;
-	cairo_text_extents(cr, text.c_str(), &extents);
+	const cairo_text_extents_t& extents = LayOutText(text).extents;
 	if (w != nullptr)
 		*w = extents.width;
 	if (h != nullptr)
@@ -16,14 +16,22 @@
 // along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <cstdlib>
 #include <cstring>
 
 #include "graphcoloring/graphcoloring.hpp"
+#include "graphcoloring/renderbenchmark.hpp"
+#include "graphcoloring/solvers/benchmark.hpp"
+#include "graphcoloring/solvers/leveloptimizer.hpp"
+#include "utils/profiler.hpp"
 
 #define GRAPHCOLORING_VERSION "GraphColoring v. 0.0.0"
 
 int main(int argc, char** argv)
 {
+	int threads = 1; // For benchmarks
+	int frames = 100; // For --benchmark-rendering
+	std::string png_directory;
 	for (int i = 0; i < argc; i++)
 	{
 		if (!strcmp(argv[i], "--version"))
@@ -31,9 +39,44 @@ int main(int argc, char** argv)
 			std::cout << GRAPHCOLORING_VERSION << std::endl;
 			return 0;
 		}
+		if (!strcmp(argv[i], "--dump-values"))
+			graphcoloring::ValueLoader::dump_values = true;
+		if (!strcmp(argv[i], "--frame-stats"))
+			gui::Window::print_frame_stats = true;
+		if (!strcmp(argv[i], "--profile") && i+1 < argc) // Dump timings to a file at exit
+			utils::profiler::DumpAtExit(argv[++i]);
+		if (!strcmp(argv[i], "--threads") && i+1 < argc)
+			threads = atoi(argv[++i]);
+		if (!strcmp(argv[i], "--frames") && i+1 < argc)
+			frames = atoi(argv[++i]);
+		if (!strcmp(argv[i], "--png") && i+1 < argc)
+			png_directory = argv[++i];
+		if (!strcmp(argv[i], "--benchmark-coloring")) // Remaining arguments are DIMACS files
+			return graphcoloring::solvers::RunColoringBenchmark(
+				std::vector<std::string>(argv + i + 1, argv + argc), 10, threads);
+		if (!strcmp(argv[i], "--benchmark-greedy")) // Remaining arguments are DIMACS files
+			return graphcoloring::solvers::RunGreedyBenchmark(
+				std::vector<std::string>(argv + i + 1, argv + argc));
+		if (!strcmp(argv[i], "--benchmark-rules")) // Remaining arguments are category/level
+			return graphcoloring::solvers::RunRuleBenchmark(
+				std::vector<std::string>(argv + i + 1, argv + argc));
+		if (!strcmp(argv[i], "--optimize-levels")) // Remaining arguments are category/level
+			return graphcoloring::solvers::RunLevelOptimizer(
+				std::vector<std::string>(argv + i + 1, argv + argc), threads,
+				graphcoloring::solvers::LevelOptimizer::Options());
+		if (!strcmp(argv[i], "--benchmark-rendering")) // Remaining arguments are category/level
+			return graphcoloring::RunRenderBenchmark(
+				std::vector<std::string>(argv + i + 1, argv + argc), frames,
+				png_directory);
 	}
 
+#ifdef HEADLESS
+	// Built without GTK (the RenderBenchmark target), so there's no game.
+	return graphcoloring::RunRenderBenchmark(std::vector<std::string>(),
+		frames, png_directory);
+#else
 	graphcoloring::GraphColoring graphColoring;
 	graphColoring.Start();
     return 0;
+#endif
 }
@@ -68,5 +68,13 @@ bool directory_exists(std::string path)
 	return false;
 }
 
+time_t modification_time(std::string path)
+{
+	struct stat info;
+	if (stat(path.c_str(), &info))
+		return -1;
+	return info.st_mtime;
+}
+
 } // namespace filesystem
 } // namespace utils
@@ -19,6 +19,7 @@
 #define GRAPHCOLORING_UTILS_FILESYSTEM_H_
 
 #include <string>
+#include <ctime>
 
 namespace utils {
 namespace filesystem {
@@ -27,6 +28,7 @@ extern void remove_file(std::string path);
 extern void copy_file(std::string src, std::string dest);
 extern void create_directory(std::string path);
 extern bool directory_exists(std::string path);
+extern time_t modification_time(std::string path); // -1 if the file does not exist
 
 } // namespace filesystem
 } // namespace utils
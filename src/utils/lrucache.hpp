@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_UTILS_LRUCACHE_H_
+#define GRAPHCOLORING_UTILS_LRUCACHE_H_
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace utils {
+
+// A map which holds at most capacity entries. When it's full, inserting
+// evicts the least recently used entry.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LRUCache {
+public:
+	explicit LRUCache(size_t capacity_) : capacity(capacity_) {}
+	// Returns nullptr if key isn't in the cache. The pointer is valid until
+	// the next insertion.
+	const Value* Find(const Key& key)
+	{
+		auto it = positions.find(key);
+		if (it == positions.end()) return nullptr;
+		entries.splice(entries.begin(), entries, it->second);
+		return &it->second->second;
+	}
+	void Insert(const Key& key, const Value& value)
+	{
+		auto it = positions.find(key);
+		if (it != positions.end())
+		{
+			it->second->second = value;
+			entries.splice(entries.begin(), entries, it->second);
+			return;
+		}
+		if (capacity == 0) return;
+		if (entries.size() >= capacity)
+		{
+			positions.erase(entries.back().first);
+			entries.pop_back();
+		}
+		entries.emplace_front(key, value);
+		positions[key] = entries.begin();
+	}
+	size_t Size() const { return entries.size(); }
+	void Clear()
+	{
+		entries.clear();
+		positions.clear();
+	}
+private:
+	typedef std::list<std::pair<Key, Value>> list_t;
+	const size_t capacity;
+	list_t entries; // Most recently used first
+	std::unordered_map<Key, typename list_t::iterator, Hash> positions;
+};
+
+} // namespace utils
+
+#endif // GRAPHCOLORING_UTILS_LRUCACHE_H_
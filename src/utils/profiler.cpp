@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <mutex>
+
+namespace utils {
+namespace profiler {
+
+namespace {
+
+// The last SAMPLES values, oldest overwritten first
+struct Series
+{
+	std::vector<double> samples;
+	long long total = 0;
+};
+
+typedef std::map<std::string, Series, std::less<>> series_map_t;
+
+std::atomic<bool> is_enabled(false);
+std::mutex mutex; // For everything below
+series_map_t sections, counters;
+std::string dump_filename;
+
+void Record(series_map_t& map, const char* name, double value)
+{
+	if (!IsEnabled()) return;
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = map.find(name);
+	if (it == map.end())
+		it = map.emplace(name, Series()).first;
+	Series& series = it->second;
+	if (series.samples.size() < SAMPLES)
+		series.samples.push_back(value);
+	else
+		series.samples[series.total % SAMPLES] = value;
+	series.total++;
+}
+
+std::vector<Stats> GetStats(const series_map_t& map, double scale)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	std::vector<Stats> all;
+	for (const auto& entry : map)
+	{
+		std::vector<double> samples = entry.second.samples;
+		std::sort(samples.begin(), samples.end());
+		Stats stats;
+		stats.name = entry.first;
+		stats.total = entry.second.total;
+		stats.min = scale * samples.front();
+		double sum = 0;
+		for (double sample : samples) sum += sample;
+		stats.average = scale * sum / samples.size();
+		size_t p99 = (size_t)std::ceil(0.99 * samples.size()) - 1;
+		stats.p99 = scale * samples[p99];
+		all.push_back(stats);
+	}
+	return all;
+}
+
+void WriteTable(std::ostream& out, const std::string& title,
+	const std::vector<Stats>& all)
+{
+	out << std::left << std::setw(32) << title << std::right
+		<< std::setw(12) << "samples" << std::setw(12) << "min"
+		<< std::setw(12) << "avg" << std::setw(12) << "p99" << "\n";
+	for (const Stats& stats : all)
+		out << std::left << std::setw(32) << stats.name << std::right
+			<< std::setw(12) << stats.total << std::fixed
+			<< std::setprecision(4) << std::setw(12) << stats.min
+			<< std::setw(12) << stats.average << std::setw(12) << stats.p99
+			<< "\n";
+}
+
+void DumpNow()
+{
+	Dump(dump_filename);
+	is_enabled = false; // Other threads may still be running.
+}
+
+} // namespace
+
+void Enable()
+{
+	is_enabled = true;
+}
+
+bool IsEnabled()
+{
+	return is_enabled.load(std::memory_order_relaxed);
+}
+
+void RecordTime(const char* section, double seconds)
+{
+	Record(sections, section, seconds);
+}
+
+void RecordCount(const char* counter, double value)
+{
+	Record(counters, counter, value);
+}
+
+std::vector<Stats> Sections()
+{
+	return GetStats(sections, 1000);
+}
+
+std::vector<Stats> Counters()
+{
+	return GetStats(counters, 1);
+}
+
+bool Dump(const std::string& filename)
+{
+	std::ofstream file(filename);
+	WriteTable(file, "section (ms)", Sections());
+	file << "\n";
+	WriteTable(file, "counter (per frame)", Counters());
+	return (bool)file;
+}
+
+void DumpAtExit(const std::string& filename)
+{
+	Enable();
+	bool is_registered = !dump_filename.empty();
+	dump_filename = filename;
+	if (!is_registered) std::atexit(DumpNow);
+}
+
+} // namespace profiler
+} // namespace utils
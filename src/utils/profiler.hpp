@@ -0,0 +1,80 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2018 Leo Tenenbaum
+// This file is part of GraphColoring.
+//
+// GraphColoring is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// GraphColoring is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with GraphColoring.  If not, see <https://www.gnu.org/licenses/>.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef GRAPHCOLORING_UTILS_PROFILER_H_
+#define GRAPHCOLORING_UTILS_PROFILER_H_
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace utils {
+namespace profiler {
+
+// Statistics over the most recent SAMPLES samples of a section or counter.
+// Sections are in milliseconds.
+struct Stats
+{
+	std::string name;
+	long long total = 0; // Number of samples ever recorded
+	double min = 0, average = 0, p99 = 0;
+};
+
+constexpr int SAMPLES = 256;
+
+// Nothing is recorded until this is called, so the timers cost one branch.
+extern void Enable();
+extern bool IsEnabled();
+// These can be called from any thread.
+extern void RecordTime(const char* section, double seconds);
+extern void RecordCount(const char* counter, double value);
+extern std::vector<Stats> Sections(); // Sorted by name
+extern std::vector<Stats> Counters();
+// Write every section and counter to filename. Returns false on failure.
+extern bool Dump(const std::string& filename);
+// Enable profiling and Dump to filename when the program exits.
+extern void DumpAtExit(const std::string& filename);
+
+// Records the time from its construction to its destruction under section,
+// which should be a string literal.
+class ScopedTimer
+{
+public:
+	explicit ScopedTimer(const char* section_)
+		: section(section_), is_timing(IsEnabled())
+	{
+		if (is_timing) start = std::chrono::steady_clock::now();
+	}
+	~ScopedTimer()
+	{
+		if (!is_timing) return;
+		RecordTime(section, std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start).count());
+	}
+	ScopedTimer(const ScopedTimer&) = delete;
+	ScopedTimer& operator=(const ScopedTimer&) = delete;
+private:
+	const char* section;
+	bool is_timing;
+	std::chrono::steady_clock::time_point start;
+};
+
+} // namespace profiler
+} // namespace utils
+
+#endif // GRAPHCOLORING_UTILS_PROFILER_H_